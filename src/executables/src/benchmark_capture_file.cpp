@@ -0,0 +1,87 @@
+/**
+ * @file benchmark_capture_file.cpp
+ * @brief contains the entrance to a benchmark comparing writing and loading
+ * measurements as CSV (measurementsToFile/measurementsFromFile) with the
+ * binary CaptureFile (measurementsToCapture/CaptureFile::open).
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <timer/capture_file.hpp>
+#include <timer/collecting_timer.hpp>
+#include <vector>
+
+namespace benchmark {
+using ns = std::chrono::nanoseconds;
+
+constexpr size_t NUM_VALUES = size_t{1} << 22U;
+constexpr int NUM_RUNS      = 3;
+}  // namespace benchmark
+
+int main() {
+  using namespace benchmark;  // NOLINT This is a single file executable
+
+  std::mt19937_64 generator(42);  // NOLINT fixed seed for repeatable runs
+  std::lognormal_distribution<double> durations(12., 0.5);
+  std::vector<PreciseTime> values;
+  values.reserve(NUM_VALUES);
+  for (size_t i = 0; i < NUM_VALUES; ++i) {
+    values.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+  }
+  CollectingTimer capture(values, "capture");
+
+  const std::string csv_file    = "benchmark_capture_file.csv";
+  const std::string binary_file = "benchmark_capture_file.bin";
+  std::remove(csv_file.c_str());
+  std::remove(binary_file.c_str());
+
+  // every step NUM_RUNS times, the files of the last run stay for the next step
+  CollectingTimer timer;
+  std::vector<std::string> steps;
+  auto run = [&timer, &steps](const std::string& name, auto&& step) {
+    steps.push_back(name);
+    for (int iteration = 0; iteration < NUM_RUNS; ++iteration) {
+      timer.start(name);
+      step();
+      timer.stop(name);
+    }
+  };
+
+  run("write csv", [&]() {
+    std::remove(csv_file.c_str());  // measurementsToFile appends
+    capture.measurementsToFile<ns>(csv_file, ',');
+  });
+  run("write capture", [&]() { capture.measurementsToCapture(binary_file); });
+
+  std::vector<std::string> names;
+  std::vector<std::vector<PreciseTime>> columns;
+  run("load csv", [&]() {
+    CollectingTimer::measurementsFromFile<ns>(csv_file, ',', names, columns);
+  });
+  CaptureFile file;
+  run("open capture", [&]() { file.open(binary_file); });
+
+  CollectingTimer::Result result;
+  run("getResult on the mapped capture", [&]() {
+    CollectingTimer::getResult(file, "capture", result);
+  });
+
+  std::cout << NUM_VALUES << " measurements (median of " << NUM_RUNS << " runs):\n";
+  for (const std::string& name : steps) {
+    CollectingTimer::Result timing;
+    timer.getResult(name, timing);
+    std::cout << name << ":\t" << timing.median.getTimeString(3) << "\n";
+  }
+  std::cout << "median " << result.median << "\n";
+
+  file.close();
+  std::remove(csv_file.c_str());
+  std::remove(binary_file.c_str());
+  return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file benchmark_collecting_timer.cpp
+ * @brief contains the entrance to a microbenchmark measuring the overhead of
+ * CollectingTimer::start() and stop() by name and by TimerId, for the steady
+ * and the time stamp counter clock.
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <timer/collecting_timer.hpp>
+#include <vector>
+
+namespace benchmark {
+constexpr size_t NUM_PAIRS = 1000;
+constexpr int NUM_RUNS     = 200;
+
+const std::array<std::string, 8> NAMES = {"physics/broadphase",
+                                          "physics/narrowphase",
+                                          "physics/solver",
+                                          "render/culling",
+                                          "render/draw_calls",
+                                          "render/post_processing",
+                                          "audio/mixer",
+                                          "network/receive"};
+
+/**
+ * @brief Measures NUM_RUNS times NUM_PAIRS start()/stop() pairs, cycling
+ * through all NAMES.
+ * @param use_ids Call start/stop with the TimerIds instead of the names.
+ */
+template <class Clock>
+void run(CollectingTimer& timer, const std::string& name, bool use_ids) {
+  const CollectingTimer::TimerId run_id = timer.registerTimer(name);
+  timer.reserve(run_id, NUM_RUNS);
+
+  BasicCollectingTimer<Clock> measured;
+  std::vector<typename BasicCollectingTimer<Clock>::TimerId> ids;
+  for (const auto& timer_name : NAMES) {
+    ids.push_back(measured.registerTimer(timer_name));
+    measured.reserve(ids.back(), NUM_PAIRS * NUM_RUNS);
+  }
+
+  for (int iteration = 0; iteration < NUM_RUNS; ++iteration) {
+    timer.start(run_id);
+    for (size_t i = 0; i < NUM_PAIRS; ++i) {
+      const size_t t = i % NAMES.size();
+      if (use_ids) {
+        measured.start(ids[t]);
+        measured.stop(ids[t]);
+      } else {
+        measured.start(NAMES[t]);
+        measured.stop(NAMES[t]);
+      }
+    }
+    timer.stop(run_id);
+  }
+}
+}  // namespace benchmark
+
+int main() {
+  using namespace benchmark;  // NOLINT This is a single file executable
+
+  const std::vector<std::string> names = {
+    "steady by name", "steady by id", "tsc by name", "tsc by id"};
+  CollectingTimer timer;
+  TscClock::calibrate();
+  run<SteadyClock>(timer, names[0], false);
+  run<SteadyClock>(timer, names[1], true);
+  run<TscClock>(timer, names[2], false);
+  run<TscClock>(timer, names[3], true);
+
+  std::cout << "Time for " << NUM_PAIRS << " start/stop pairs (median of " << NUM_RUNS
+            << " runs), time stamp counter "
+            << (TscClock::usesTsc() ? "used" : "not invariant, steady clock used") << ":\n";
+  for (const auto& name : names) {
+    CollectingTimer::Result result;
+    timer.getResult(name, result);
+    std::cout << name << ":\t" << result.median.getTimeString(3) << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file benchmark_compressed_column.cpp
+ * @brief contains the entrance to a benchmark comparing the memory and the
+ * getResult() time of a SAMPLES timer (int64_t per measurement) with a
+ * COMPRESSED timer (bit-packed differences, decoded block by block).
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <timer/collecting_timer.hpp>
+#include <timer/compressed_column.hpp>
+#include <vector>
+
+namespace benchmark {
+using ns = std::chrono::nanoseconds;
+
+constexpr size_t NUM_VALUES = size_t{1} << 22U;
+constexpr int NUM_RUNS      = 5;
+}  // namespace benchmark
+
+int main() {
+  using namespace benchmark;  // NOLINT This is a single file executable
+
+  // a function of ~20us whose runs differ by a few hundred ns
+  std::mt19937_64 generator(42);  // NOLINT fixed seed for repeatable runs
+  std::normal_distribution<double> durations(20000., 300.);
+  std::vector<PreciseTime> values;
+  values.reserve(NUM_VALUES);
+  CompressedColumn column;
+  for (size_t i = 0; i < NUM_VALUES; ++i) {
+    const auto nanos = static_cast<int64_t>(durations(generator));
+    values.emplace_back(ns(nanos));
+    column.push_back(nanos);
+  }
+  std::cout << "bytes per measurement: SAMPLES " << sizeof(int64_t) << ", COMPRESSED "
+            << static_cast<double>(column.packedBytes()) / static_cast<double>(NUM_VALUES)
+            << ", PreciseTime " << sizeof(PreciseTime) << "\n";
+
+  const CollectingTimer samples(values, "m");
+  CollectingTimer compressed(values, "m");
+  compressed.setStorage(compressed.registerTimer("m"), CollectingTimer::Storage::COMPRESSED);
+  compressed.setReportThreads(1);
+
+  CollectingTimer timer;
+  CollectingTimer::Result result;
+  for (int iteration = 0; iteration < NUM_RUNS; ++iteration) {
+    // a fresh copy, the measurements are reordered for the median
+    CollectingTimer copy = samples;
+    copy.setReportThreads(1);
+    timer.start("SAMPLES");
+    copy.getResult("m", result);
+    timer.stop("SAMPLES");
+    timer.start("COMPRESSED");
+    compressed.getResult("m", result);
+    timer.stop("COMPRESSED");
+  }
+
+  std::cout << "getResult of " << NUM_VALUES << " measurements on 1 thread (median of " << NUM_RUNS
+            << " runs):\n";
+  for (const std::string name : {"SAMPLES", "COMPRESSED"}) {
+    CollectingTimer::Result timing;
+    timer.getResult(name, timing);
+    std::cout << name << ":\t" << timing.median.getTimeString(3) << "\n";
+  }
+  std::cout << "mean " << result.mean << " median " << result.median << "\n";
+  return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file benchmark_concurrent_collecting_timer.cpp
+ * @brief contains the entrance to a benchmark measuring how start() and
+ * stop() of the ConcurrentCollectingTimer scale with the number of threads,
+ * compared with a CollectingTimer guarded by a mutex.
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <timer/collecting_timer.hpp>
+#include <timer/concurrent_collecting_timer.hpp>
+#include <vector>
+
+namespace benchmark {
+constexpr size_t NUM_PAIRS   = 100000;
+constexpr int NUM_RUNS       = 5;
+constexpr size_t MAX_THREADS = 64;
+
+/**
+ * @brief Lets num_threads threads record NUM_PAIRS start()/stop() pairs each,
+ * NUM_RUNS times, and measures the wall time of each run under the given name.
+ * The threads are started and run setup() (e.g. allocate their buffers)
+ * before the time is taken, the run is timed from releasing them at once to
+ * the last join.
+ * @param setup Called by every thread before the run, returns the TimerId
+ * it records into.
+ * @param record Called by every thread with the TimerId from setup().
+ */
+template <class Setup, class Record>
+void run(CollectingTimer& timer, const std::string& name, size_t num_threads, Setup setup, Record record) {
+  for (int iteration = 0; iteration < NUM_RUNS; ++iteration) {
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&setup, &record, &ready, &go]() {
+        const auto id = setup();
+        ++ready;
+        while (!go.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+        record(id);
+      });
+    }
+    while (ready.load(std::memory_order_acquire) < num_threads) {
+      std::this_thread::yield();
+    }
+    timer.start(name);
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    timer.stop(name);
+  }
+}
+}  // namespace benchmark
+
+int main() {
+  using namespace benchmark;  // NOLINT This is a single file executable
+
+  CollectingTimer timer;
+  std::vector<std::pair<size_t, std::string>> names;
+  for (size_t num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+    const std::string threads = std::to_string(num_threads) + " threads";
+
+    ConcurrentCollectingTimer concurrent;
+    const auto id = concurrent.registerTimer("work");
+    names.emplace_back(num_threads, "concurrent " + threads);
+    run(
+      timer,
+      names.back().second,
+      num_threads,
+      [&concurrent, id]() {
+        concurrent.reserve(id, NUM_PAIRS * NUM_RUNS);
+        return id;
+      },
+      [&concurrent](ConcurrentCollectingTimer::TimerId thread_id) {
+        for (size_t i = 0; i < NUM_PAIRS; ++i) {
+          concurrent.start(thread_id);
+          concurrent.stop(thread_id);
+        }
+      });
+
+    // a CollectingTimer does not support two running measurements of one
+    // timer, every thread gets its own timer but they share the lock
+    CollectingTimer locked;
+    std::mutex mutex;
+    std::vector<CollectingTimer::TimerId> ids;
+    for (size_t t = 0; t < num_threads; ++t) {
+      ids.push_back(locked.registerTimer("work " + std::to_string(t)));
+      locked.reserve(ids.back(), NUM_PAIRS * NUM_RUNS);
+    }
+    std::atomic<size_t> next_id{0};
+    names.emplace_back(num_threads, "mutex " + threads);
+    run(
+      timer,
+      names.back().second,
+      num_threads,
+      [&ids, &next_id]() { return ids[next_id++ % ids.size()]; },
+      [&locked, &mutex](CollectingTimer::TimerId thread_id) {
+        for (size_t i = 0; i < NUM_PAIRS; ++i) {
+          const std::lock_guard<std::mutex> lock(mutex);
+          locked.start(thread_id);
+          locked.stop(thread_id);
+        }
+      });
+  }
+
+  std::cout << "Time for " << NUM_PAIRS
+            << " start/stop pairs per thread (median of " << NUM_RUNS << " runs) on "
+            << std::thread::hardware_concurrency()
+            << " hardware threads, with linear scaling the time of a run stays constant up to "
+               "the number of hardware threads:\n";
+  for (const auto& [num_threads, name] : names) {
+    CollectingTimer::Result result;
+    timer.getResult(name, result);
+    const PreciseTime per_pair =
+      result.median / static_cast<double>(NUM_PAIRS * num_threads);
+    std::cout << name << ":\t" << result.median.getTimeString(3) << "\t"
+              << per_pair.getTimeString(3) << " per pair\n";
+  }
+  return 0;
+}
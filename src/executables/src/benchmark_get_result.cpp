@@ -0,0 +1,70 @@
+/**
+ * @file benchmark_get_result.cpp
+ * @brief contains the entrance to a benchmark measuring
+ * CollectingTimer::getResult() (statistics, outliners, median and histogram)
+ * on a large capture, on one thread and on all hardware threads.
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <timer/collecting_timer.hpp>
+#include <vector>
+
+namespace benchmark {
+using ns = std::chrono::nanoseconds;
+
+constexpr size_t NUM_VALUES = size_t{1} << 22U;
+constexpr int NUM_RUNS      = 10;
+}  // namespace benchmark
+
+int main() {
+  using namespace benchmark;  // NOLINT This is a single file executable
+
+  std::mt19937_64 generator(42);  // NOLINT fixed seed for repeatable runs
+  std::lognormal_distribution<double> durations(12., 0.5);
+  std::vector<PreciseTime> values;
+  values.reserve(NUM_VALUES);
+  for (size_t i = 0; i < NUM_VALUES; ++i) {
+    values.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+  }
+  const CollectingTimer capture(values, "capture");
+
+  CollectingTimer timer;
+  CollectingTimer::Result result;
+  const size_t hardware_threads = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<size_t> thread_counts = {1};
+  if (hardware_threads > 1) {
+    thread_counts.push_back(hardware_threads);
+  }
+  std::vector<std::string> names;
+  for (const size_t num_threads : thread_counts) {
+    names.push_back(std::to_string(num_threads) + " threads");
+    for (int iteration = 0; iteration < NUM_RUNS; ++iteration) {
+      // a fresh copy, the measurements are reordered for the median
+      CollectingTimer copy = capture;
+      copy.setReportThreads(num_threads);
+      CollectingTimer::Result r;
+      timer.start(names.back());
+      copy.getResult("capture", r);
+      timer.stop(names.back());
+      result = r;
+    }
+  }
+
+  std::cout << "getResult of " << NUM_VALUES << " measurements (median of "
+            << NUM_RUNS << " runs):\n";
+  for (const std::string& name : names) {
+    CollectingTimer::Result timing;
+    timer.getResult(name, timing);
+    std::cout << name << ":\t" << timing.median.getTimeString(3) << "\n";
+  }
+  std::cout << "mean " << result.mean << " outliners " << result.number_outliners << "\n";
+  return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file benchmark_precise_time.cpp
+ * @brief contains the entrance to a microbenchmark comparing the integer
+ * arithmetic kernels of PreciseTime with a round trip through double.
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <timer/collecting_timer.hpp>
+#include <vector>
+
+namespace benchmark {
+using ns = std::chrono::nanoseconds;
+using s  = std::chrono::seconds;
+
+constexpr size_t NUM_VALUES = 4096;
+constexpr int NUM_RUNS      = 200;
+
+// The double path: every operation converts to double and back.
+PreciseTime addDouble(const PreciseTime& a, const PreciseTime& b) noexcept {
+  PreciseTime r;
+  r.setNanoseconds(a.toDouble<ns>() + b.toDouble<ns>());
+  return r;
+}
+
+PreciseTime scaleDouble(const PreciseTime& a, double factor) noexcept {
+  PreciseTime r;
+  r.setNanoseconds(a.toDouble<ns>() * factor);
+  return r;
+}
+
+PreciseTimePow<2> squareDouble(const PreciseTime& a) noexcept {
+  PreciseTimePow<2> r;
+  r.setSeconds(a.toDouble<s>() * a.toDouble<s>());
+  return r;
+}
+
+PreciseTimePow<0> divideDouble(const PreciseTime& a, const PreciseTime& b) noexcept {
+  PreciseTimePow<0> r;
+  r.setSeconds(a.toDouble<s>() / b.toDouble<s>());
+  return r;
+}
+
+bool lessDouble(const PreciseTime& a, const PreciseTime& b) noexcept {
+  return a.toDouble<ns>() < b.toDouble<ns>();
+}
+
+/**
+ * @brief Runs op over all values NUM_RUNS times and measures every run.
+ * @return The number of results which differ from the reference.
+ */
+template <class Op, class Reference>
+size_t run(CollectingTimer& timer, const std::string& name, Op op, Reference reference) {
+  // the results are stored so the compiler can not drop the operations
+  std::vector<decltype(op(size_t{0}))> results(NUM_VALUES);
+  for (int iteration = 0; iteration < NUM_RUNS; ++iteration) {
+    timer.start(name);
+    for (size_t i = 0; i + 1 < NUM_VALUES; ++i) {
+      results[i] = op(i);
+    }
+    timer.stop(name);
+  }
+  size_t num_different = 0;
+  for (size_t i = 0; i + 1 < NUM_VALUES; ++i) {
+    num_different += results[i] != reference(i) ? 1U : 0U;
+  }
+  return num_different;
+}
+}  // namespace benchmark
+
+int main() {
+  using namespace benchmark;  // NOLINT This is a single file executable
+
+  std::mt19937_64 generator(42);  // NOLINT fixed seed for repeatable runs
+  std::uniform_int_distribution<int64_t> durations(1, int64_t{3600000000000});
+  std::vector<PreciseTime> values;
+  values.reserve(NUM_VALUES);
+  for (size_t i = 0; i < NUM_VALUES; ++i) {
+    values.emplace_back(ns(durations(generator)));
+  }
+  const double factor = 1. / 3.3;
+
+  CollectingTimer timer;
+  std::vector<std::pair<std::string, size_t>> differences;
+  auto compare = [&](const std::string& name, auto integer, auto floating) {
+    run(timer, name + " integer", integer, floating);
+    differences.emplace_back(name, run(timer, name + " double", floating, integer));
+  };
+
+  compare(
+    "a + b",
+    [&](size_t i) { return values[i] + values[i + 1]; },
+    [&](size_t i) { return addDouble(values[i], values[i + 1]); });
+  compare(
+    "a * f",
+    [&](size_t i) { return values[i] * factor; },
+    [&](size_t i) { return scaleDouble(values[i], factor); });
+  compare(
+    "a * a",
+    [&](size_t i) { return values[i] * values[i]; },
+    [&](size_t i) { return squareDouble(values[i]); });
+  compare(
+    "a / b",
+    [&](size_t i) { return values[i] / values[i + 1]; },
+    [&](size_t i) { return divideDouble(values[i], values[i + 1]); });
+  compare(
+    "a < b",
+    [&](size_t i) { return values[i] < values[i + 1]; },
+    [&](size_t i) { return lessDouble(values[i], values[i + 1]); });
+
+  std::cout << "Time for " << NUM_VALUES - 1 << " operations (median of " << NUM_RUNS
+            << " runs):\n";
+  for (const auto& [name, num_different] : differences) {
+    CollectingTimer::Result integer;
+    CollectingTimer::Result floating;
+    timer.getResult(name + " integer", integer);
+    timer.getResult(name + " double", floating);
+    std::cout << name << ":\tinteger " << integer.median.getTimeString(3) << "\tdouble "
+              << floating.median.getTimeString(3) << "\tresults differing: " << num_different
+              << "\n";
+  }
+  return 0;
+}
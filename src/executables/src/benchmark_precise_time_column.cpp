@@ -0,0 +1,133 @@
+/**
+ * @file benchmark_precise_time_column.cpp
+ * @brief contains the entrance to a microbenchmark comparing the reductions
+ * of PreciseTimeColumn (per instruction set) with loops over a
+ * std::vector<PreciseTime>.
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <timer/collecting_timer.hpp>
+#include <timer/precise_time_column.hpp>
+#include <vector>
+
+namespace benchmark {
+using ns  = std::chrono::nanoseconds;
+using Isa = column_kernels::Isa;
+
+constexpr size_t NUM_VALUES = size_t{1} << 22U;
+constexpr int NUM_RUNS      = 20;
+
+const char* isaName(Isa isa) {
+  switch (isa) {
+    case Isa::AVX2: return "avx2";
+    case Isa::SSE42: return "sse4.2";
+    case Isa::NEON: return "neon";
+    default: return "scalar";
+  }
+}
+
+/**
+ * @brief Measures op NUM_RUNS times under the given name.
+ * @return The result of the last run, so the compiler can not drop op.
+ */
+template <class Op>
+auto run(CollectingTimer& timer, const std::string& name, Op op) {
+  auto result = op();
+  for (int iteration = 0; iteration < NUM_RUNS; ++iteration) {
+    timer.start(name);
+    result = op();
+    timer.stop(name);
+  }
+  return result;
+}
+}  // namespace benchmark
+
+int main() {
+  using namespace benchmark;  // NOLINT This is a single file executable
+
+  std::mt19937_64 generator(42);  // NOLINT fixed seed for repeatable runs
+  std::normal_distribution<double> durations(1e6, 1e5);
+  std::vector<PreciseTime> values;
+  values.reserve(NUM_VALUES);
+  for (size_t i = 0; i < NUM_VALUES; ++i) {
+    values.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+  }
+  const PreciseTimeColumn column(values);
+  const int64_t* data        = column.data();
+  const PreciseTime mean     = column.sum() / static_cast<double>(NUM_VALUES);
+  const int64_t mean_ns      = PreciseTimeColumn::toNanoseconds(mean);
+  constexpr int64_t LOWEST   = std::numeric_limits<int64_t>::min();
+  constexpr int64_t HIGHEST  = std::numeric_limits<int64_t>::max();
+
+  std::vector<Isa> isas = {Isa::SCALAR};
+  if (column_kernels::bestIsa() == Isa::AVX2) {
+    isas.push_back(Isa::SSE42);
+  }
+  if (column_kernels::bestIsa() != Isa::SCALAR) {
+    isas.push_back(column_kernels::bestIsa());
+  }
+
+  CollectingTimer timer;
+  std::vector<std::string> names;
+  bool all_equal   = true;
+  int64_t checksum = 0;  // printed, so the compiler can not drop the reductions
+
+  const PreciseTime vector_sum = run(timer, "sum vector<PreciseTime>", [&] {
+    PreciseTime sum;
+    for (const auto& value : values) {
+      sum += value;
+    }
+    return sum;
+  });
+  const PreciseTimePow<2> vector_squares = run(timer, "sumOfSquares vector<PreciseTime>", [&] {
+    PreciseTimePow<2> sum;
+    for (const auto& value : values) {
+      const PreciseTime diff  = value - mean;
+      sum                    += diff * diff;
+    }
+    return sum;
+  });
+  names.emplace_back("sum vector<PreciseTime>");
+  names.emplace_back("sumOfSquares vector<PreciseTime>");
+
+  for (const Isa isa : isas) {
+    const std::string suffix = std::string(" ") + isaName(isa);
+    size_t count             = 0;
+    const auto sum           = run(timer, "sum" + suffix, [&] {
+      return column_kernels::sum(data, NUM_VALUES, LOWEST, HIGHEST, count, isa);
+    });
+    const auto squares       = run(timer, "sumOfSquares" + suffix, [&] {
+      return column_kernels::sumOfSquares(data, NUM_VALUES, mean_ns, LOWEST, HIGHEST, isa);
+    });
+    checksum += run(timer, "minMax" + suffix, [&] {
+      int64_t min = 0;
+      int64_t max = 0;
+      column_kernels::minMax(data, NUM_VALUES, LOWEST, HIGHEST, min, max, isa);
+      return min + max;
+    });
+    checksum += static_cast<int64_t>(run(timer, "countInRange" + suffix, [&] {
+      return column_kernels::countInRange(data, NUM_VALUES, mean_ns - 100000, mean_ns + 100000, isa);
+    }));
+    all_equal = all_equal && PreciseTime::fromCount(sum) == vector_sum &&
+                PreciseTimePow<2>::fromCount(squares) == vector_squares;
+    for (const char* kernel : {"sum", "sumOfSquares", "minMax", "countInRange"}) {
+      names.push_back(kernel + suffix);
+    }
+  }
+
+  std::cout << "Time to reduce " << NUM_VALUES << " values (median of " << NUM_RUNS << " runs):\n";
+  for (const auto& name : names) {
+    CollectingTimer::Result result;
+    timer.getResult(name, result);
+    std::cout << name << ":\t" << result.median.getTimeString(3) << "\n";
+  }
+  std::cout << "all results equal: " << (all_equal ? "yes" : "no") << " (" << checksum << ")\n";
+  return all_equal ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file example_precise_time.cpp
+ * @brief contains the PreciseTime example of the README. It is built with the
+ * executables, so the example in the README keeps compiling: the build fails
+ * if the code below and the one in the README differ.
+ *
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#include <timer/precise_time.hpp>
+
+#include <array>
+#include <iostream>
+#include <string>
+
+int main() {
+  constexpr PreciseTime max_pt = PreciseTime::max();
+  constexpr PreciseTime min_pt = PreciseTime::min();
+  std::cout << "max: " << max_pt << "\n"
+            << "min: " << min_pt << "\n";
+
+  using ns = std::chrono::nanoseconds;
+  using us = std::chrono::microseconds;
+  using ms = std::chrono::milliseconds;
+
+  // construction
+  PreciseTime my_time1(ns(987654321));
+  std::cout << "1. " << my_time1 << "\n";
+  PreciseTime my_time2(ms(42));
+  std::cout << "2. " << my_time2 << "\n";
+  constexpr PreciseTime my_time3 = ns(22) + us(450) + ms(12);
+  std::cout << "3. " << my_time3 << "\n";
+
+  constexpr std::array<long, 6> seperated_times = my_time3.getSeperatedTimeComponents();
+  const std::array<std::string, 6> info = {
+      "nanoseconds.",  "microseconds.",
+      "milliseconds.", "seconds.",
+      "minutes.",      "hours."};
+  for(size_t i = 0; i < 6; i++){
+    std::cout << seperated_times[i] << " " << info[i] << "\n";
+  }
+
+  // calculations: add/substract times
+  my_time1 = my_time1 + my_time1;
+  my_time1 -= my_time2;
+
+  // calculations: multiply/divide by factor
+  my_time2 *= 1.5;
+  my_time2 = my_time2 / 3.3;
+
+  // calculations: s*s = s^2
+  PreciseTimePow<2> timeSquared = my_time1 * my_time2;
+  // This does not compile.
+  // calculations: s^2 + s: can't mix units
+  // auto corruptedTime = timeSquared + my_time1;
+
+  // Takeing the square root only works with usints s^n where n is even.
+  PreciseTime normalTime = PreciseTimePow<2>::sqrt(timeSquared);
+  std::cout << "4. " << normalTime << "\n";
+
+  // overflow protection
+  constexpr auto my_time4 = max_pt * 5;  // my_time4 is still max_pt
+  std::cout << "5. " << my_time4 << "\n";
+
+  // constexpr arithmetic
+  constexpr auto zero_t = max_pt - my_time4;
+  std::cout << "6. " << zero_t << "\n";
+
+  // coversations
+  typedef std::chrono::microseconds exampleType;
+
+  // This gets the time in exampleType ! this might result in resolution loss
+  // if the time is 22ns and 450us and 12ms, This returns exact 12450us
+  constexpr exampleType in_us = my_time3.convert<exampleType>();
+  std::cout << "7. " << in_us.count() << "\n";
+
+  // if the time is 22ns and 450us and 12ms, This returns exact 450us
+  constexpr exampleType part_us = my_time3.get<exampleType>();
+  std::cout << "8. " << part_us.count() << "\n";
+
+  // if the time is 22ns and 450us and 12ms, This returns exact* 12450.022
+  // double precision exact
+  constexpr double floatingPoint = my_time3.toDouble<exampleType>();
+  std::cout << "9. " << std::fixed << floatingPoint << "\n\n";
+
+  return 0;
+}
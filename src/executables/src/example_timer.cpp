@@ -1,6 +1,7 @@
 /**
  * @file example_timer.cpp
- * @brief contains the entrance to a executable demonstrating the FrameTimer class
+ * @brief contains the entrance to a executable demonstrating the FrameTimer and
+ * the CallTreeTimer class
  *
  * @date 30.08.2025
  * @author Jakob Wandel
@@ -9,14 +10,19 @@
 
 #include <chrono>
 #include <cmath>
+#include <iostream>
+#include <timer/call_tree_timer.hpp>
 #include <timer/frame_timer.hpp>
 #include <vector>
 
 namespace timedFunctions {
 static FrameTimer frameTimer;  // NOLINT This is a single file executable
+// innerLoop runs within outerLoop: the call tree reports the self time of outerLoop
+static CallTreeTimer callTree;  // NOLINT This is a single file executable
 
 static int f1(int max) {  // NOLINT This is a single file executable
   const auto t = frameTimer.startScopedTimer("innerLoop");
+  const auto node = callTree.startScopedTimer("innerLoop");
 
   int abc = 0;
   for (int j = max; j > 0; --j) {
@@ -27,6 +33,7 @@ static int f1(int max) {  // NOLINT This is a single file executable
 
 static int f2(int max) {  // NOLINT This is a single file executable
   const auto timer = frameTimer.startScopedTimer("outerLoop");
+  const auto node = callTree.startScopedTimer("outerLoop");
 
   int abc = 0;
   for (int j = max; j > 0; --j) {
@@ -37,6 +44,7 @@ static int f2(int max) {  // NOLINT This is a single file executable
 
 static int f3(int max) {  // NOLINT This is a single file executable
   const auto timer = frameTimer.startScopedTimer("cos");
+  const auto node = callTree.startScopedTimer("cos");
 
   double abc = 0;
   for (int j = max; j > 0; --j) {
@@ -47,6 +55,7 @@ static int f3(int max) {  // NOLINT This is a single file executable
 
 static int f4(int max) {  // NOLINT This is a single file executable
   const auto timer = frameTimer.startScopedTimer("sin");
+  const auto node = callTree.startScopedTimer("sin");
 
   double abc = 0;
   for (int j = max; j > 0; --j) {
@@ -70,5 +79,7 @@ int main() {
 
   timedFunctions::frameTimer.measurementsToFile<std::chrono::microseconds>(
     "/tmp/frames.csv", ';');
+  timedFunctions::callTree.treeToFile<std::chrono::microseconds>("/tmp/call_tree.csv", ';');
+  std::cout << timedFunctions::callTree;
   return erg[0];
 }
@@ -10,12 +10,22 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <timer/precise_time.hpp>
+#include <timer/precise_time_accumulator.hpp>
+#include <timer/precise_time_column.hpp>
 
+#include <algorithm>
 #include <array>
+#include <charconv>
 #include <chrono>
 #include <cstdint>
 #include <cstdio>
+#include <functional>
 #include <limits>
+#include <random>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
 
 using ns = std::chrono::nanoseconds;
 using us = std::chrono::microseconds;
@@ -28,7 +38,8 @@ using h  = std::chrono::hours64;
 static constexpr size_t NUM_TESTS = 6;
 
 namespace {
-void test_for_all_times(const PreciseTime& pt, const std::array<int64_t, NUM_TESTS>& times) {
+template <class Resolution, class MaxSpan, int Exponent>
+void test_for_all_times(const BasicPreciseTime<Resolution, MaxSpan, Exponent>& pt, const std::array<int64_t, NUM_TESTS>& times) {
   const auto pt_times = pt.getSeperatedTimeComponents();
 
   for (size_t i = 0; i < times.size(); i++) {
@@ -68,16 +79,16 @@ TEST_CASE("test_precise_time_class_min_max_rollover") {
   PreciseTime const neg_rollover_2 = max_pt * -2;
   test_for_all_times(neg_rollover_2, expected_min_times);
 
-  PreciseTime const pos_rollover_3 = min_pt * min_pt;
+  PreciseTimePow<2> const pos_rollover_3 = min_pt * min_pt;
   test_for_all_times(pos_rollover_3, expected_max_times);
 
-  PreciseTime const pos_rollover_4 = max_pt * max_pt;
+  PreciseTimePow<2> const pos_rollover_4 = max_pt * max_pt;
   test_for_all_times(pos_rollover_4, expected_max_times);
 
-  PreciseTime const neg_rollover_3 = max_pt * min_pt;
+  PreciseTimePow<2> const neg_rollover_3 = max_pt * min_pt;
   test_for_all_times(neg_rollover_3, expected_min_times);
 
-  PreciseTime const neg_rollover_4 = min_pt * max_pt;
+  PreciseTimePow<2> const neg_rollover_4 = min_pt * max_pt;
   test_for_all_times(neg_rollover_4, expected_min_times);
 
   constexpr int NUM_RUNS  = 1000;
@@ -136,15 +147,23 @@ TEST_CASE("test_precise_time_class_calculus") {  // NOLINT readability-function-
 
   constexpr PreciseTime pt_7 = s(2);
   REQUIRE(pt_7.toDouble<s>() == 2);
-  const PreciseTime pt_8 = pt_7 * pt_7;
+  constexpr PreciseTimePow<2> pt_8 = pt_7 * pt_7;
   REQUIRE(pt_8.toDouble<s>() == 4);
-  PreciseTime pt_88 = s(4);
-  pt_88.setExponent(2);
+  PreciseTimePow<2> pt_88;
+  pt_88.setSeconds(4);
   REQUIRE(pt_8 == pt_88);
 
-  REQUIRE(pt_8.getExponent() == 2);
-  const auto pt_9 = pt_8.getSqrt();
+  static_assert(PreciseTimePow<2>::getExponent() == 2, "s * s = s^2");
+  constexpr auto pt_9 = pt_8.getSqrt();
+  static_assert(std::is_same<decltype(pt_9), const PreciseTime>::value, "sqrt(s^2) = s");
+  static_assert(pt_7 == pt_9, "sqrt is constexpr");
   REQUIRE(pt_7 == pt_9);
+  static_assert(sizeof(PreciseTime) == sizeof(wide_int::int128), "the unit is not stored");
+  static_assert(!std::is_invocable<std::plus<>, PreciseTime, PreciseTimePow<2>>::value,
+                "You can not add different units like s + s^2");
+  static_assert(!std::is_invocable<std::less<>, PreciseTime, PreciseTimePow<2>>::value,
+                "You can not compare different units like s < s^2");
+  static_assert(std::is_same<decltype(pt_8 / pt_7), PreciseTime>::value, "s^2 / s = s");
 
   // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
 
@@ -234,6 +253,21 @@ TEST_CASE("test_precise_time_class_calculus") {  // NOLINT readability-function-
   REQUIRE(pt_28_exp > pt_27_exp);
   REQUIRE(pt_27_exp < pt_28_exp);
 
+  // exact integer kernels: no round trip through double
+  constexpr PreciseTime pt_31 = PreciseTime(h(1000000)) + PreciseTime(ns(3));
+  static_assert(pt_31 * 0.5 == PreciseTime(h(500000)) + PreciseTime(ns(1)), "exact scaling");
+  REQUIRE(pt_31 / 0.25 == pt_31 * 4);
+  REQUIRE(pt_0 * 1.5 == PreciseTime(ns(13183481481481)));
+  REQUIRE(pt_0 / 0.75 == PreciseTime(ns(11718650205761)));
+  // the exact product with the double closest to 1/3
+  REQUIRE(pt_31 * (1. / 3.) == PreciseTime(ns(1199999999999999934)));
+  REQUIRE((pt_31 * pt_31) / pt_31 == pt_31);
+  REQUIRE(((pt_31 * pt_31) / pt_31 * pt_31).getSqrt() == pt_31);
+  constexpr PreciseTimePow<0> ratio = PreciseTime(s(3)) / PreciseTime(s(2));
+  static_assert(ratio.toDouble<s>() == 1.5, "s / s is exact");
+  REQUIRE((ratio * PreciseTime(s(2))) == PreciseTime(s(3)));
+  REQUIRE((pt_31 / PreciseTime(ns(1))).toDouble<s>() == 3600000000000000003.);
+
   constexpr PreciseTime pt_29_exp = std::chrono::nanoseconds(1);
   constexpr PreciseTime pt_30_exp = std::chrono::seconds(1);
 
@@ -307,9 +341,9 @@ TEST_CASE("test_precise_time_class_test_to_string") {  // NOLINT readability-fun
   REQUIRE(hmsmsusns.toString() ==
           "{h: [1]   m: [1]   s: [1]   ms: [1]   us: [1]   ns: [1]}^1");
 
-  constexpr PreciseTime s_squared            = one_s * one_s;
-  constexpr PreciseTime s_cubed              = s_squared * one_s;
-  constexpr PreciseTime s_to_the_forth_power = s_cubed * one_s;
+  constexpr PreciseTimePow<2> s_squared            = one_s * one_s;
+  constexpr PreciseTimePow<3> s_cubed              = s_squared * one_s;
+  constexpr PreciseTimePow<4> s_to_the_forth_power = s_cubed * one_s;
 
   REQUIRE(s_squared.toString() ==
           "{h: [0]   m: [0]   s: [1]   ms: [0]   us: [0]   ns: [0]}^2");
@@ -319,6 +353,128 @@ TEST_CASE("test_precise_time_class_test_to_string") {  // NOLINT readability-fun
           "{h: [0]   m: [0]   s: [1]   ms: [0]   us: [0]   ns: [0]}^4");
 }
 
+TEST_CASE("test_precise_time_class_to_chars") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  constexpr PreciseTime pt = s(44) + ms(40) + us(66) + ns(12);
+  std::array<char, PreciseTime::MAX_CHARS> buffer{};
+  char* const first = buffer.data();
+  char* const last  = buffer.data() + buffer.size();
+  const auto str    = [first](std::to_chars_result r) { return std::string(first, r.ptr); };
+
+  // the string functions wrap the to_chars functions
+  auto r = pt.toChars(first, last);
+  REQUIRE(r.ec == std::errc());
+  REQUIRE(str(r) == pt.toString());
+  REQUIRE(str(r) == "{h: [0]   m: [0]   s: [44]  ms: [40]  us: [66]  ns: [12]}^1");
+  REQUIRE(str(pt.mayorTimeStringToChars(first, last)) == "44s");
+  REQUIRE(str(pt.timeStringToChars(first, last, 2)) == "44.04s");
+  REQUIRE(str(pt.timeStringToChars(first, last, 2)) == pt.getTimeString(2));
+  REQUIRE(str(pt.toChars<ms>(first, last, 3)) == "44040.066ms");
+  REQUIRE(str(pt.toChars<us>(first, last, 1)) == "44040066.0us");
+  const PreciseTime negative = PreciseTime::zero() - pt;
+  REQUIRE(str(negative.timeStringToChars(first, last, 1)) == negative.getTimeString(1));
+  REQUIRE(str(negative.toChars(first, last)) == negative.toString());
+  REQUIRE(str(PreciseTime::max().toChars(first, last)) == PreciseTime::max().toString());
+  REQUIRE(str(PreciseTime::min().toChars(first, last)) == PreciseTime::min().toString());
+
+  // a too small buffer is reported, nothing is written past its end
+  r = pt.toChars(first, first + 10);
+  REQUIRE(r.ec == std::errc::value_too_large);
+  REQUIRE(r.ptr == first + 10);
+  r = pt.timeStringToChars(first, first + 5, 2);
+  REQUIRE(r.ec == std::errc::value_too_large);
+  REQUIRE(r.ptr == first + 5);
+  REQUIRE(pt.timeStringToChars(first, first + 6, 2).ec == std::errc());
+
+#if defined(__cpp_lib_format)
+  REQUIRE(std::format("{}", pt) == pt.toString());
+  REQUIRE(std::format("{:.2}", pt) == "44.04s");
+  REQUIRE(std::format("{:ms}", pt) == "44040.066ms");
+  REQUIRE(std::format("{:.1us}", pt) == "44040066.0us");
+  REQUIRE(std::format("{:.0h}", pt) == "0h");
+#endif
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_precise_time_class_from_chars") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  const auto parse = [](const std::string& str, PreciseTime& pt) {
+    const auto r = PreciseTime::fromChars(str.data(), str.data() + str.size(), pt);
+    return r.ec == std::errc() && r.ptr == str.data() + str.size();
+  };
+  PreciseTime pt;
+
+  REQUIRE(parse("44.04s", pt));
+  REQUIRE(pt == PreciseTime(s(44) + ms(40)));
+  REQUIRE(parse("66.02us", pt));
+  REQUIRE(pt == PreciseTime(us(66) + ns(20)));
+  REQUIRE(parse("-3h", pt));
+  REQUIRE(pt == PreciseTime(h(-3)));
+  REQUIRE(parse("1.0169m", pt));
+  REQUIRE(pt == PreciseTime(ms(61014)));
+  REQUIRE(parse("1.5e3ms", pt));
+  REQUIRE(pt == PreciseTime(ms(1500)));
+  REQUIRE(parse("0.0000000004s", pt));
+  REQUIRE(pt == PreciseTime::zero());
+  REQUIRE(parse("0.0000000005s", pt));  // rounded to the nearest nanosecond
+  REQUIRE(pt == PreciseTime(ns(1)));
+  REQUIRE(parse("12345678901234567890123ns", pt));  // more than 18 digits
+  REQUIRE(pt == PreciseTime(ns(123456789012345678)) * 100000);
+
+  // round trip of all string functions
+  const PreciseTime pt_0 = h(27) + m(26) + s(28) + ms(987) + us(654) + ns(321);
+  REQUIRE(parse(pt_0.toString(), pt));
+  REQUIRE(pt == pt_0);
+  REQUIRE(parse((PreciseTime::zero() - pt_0).toString(), pt));
+  REQUIRE(pt == PreciseTime::zero() - pt_0);
+  REQUIRE(parse(PreciseTime::max().toString(), pt));
+  REQUIRE(pt == PreciseTime::max());
+  REQUIRE(parse(PreciseTime::min().toString(), pt));
+  REQUIRE(pt == PreciseTime::min());
+  REQUIRE(parse(pt_0.getMayorTimeString(), pt));
+  REQUIRE(pt == PreciseTime(h(27)));
+  REQUIRE(parse(PreciseTime(us(66) + ns(12)).getTimeString(3), pt));
+  REQUIRE(pt == PreciseTime(us(66) + ns(12)));
+
+  // a plain number in a given unit, as written by measurementsToFile
+  const std::string value = "44040.066012";
+  REQUIRE(PreciseTime::fromChars<ms>(value.data(), value.data() + value.size(), pt).ec == std::errc());
+  REQUIRE(pt == PreciseTime(s(44) + ms(40) + us(66) + ns(12)));
+
+  // the unit exponent and the resolution are respected
+  PreciseTimePow<2> pt_squared;
+  const std::string squared = PreciseTimePow<2>(PreciseTime(s(3)) * PreciseTime(s(3))).toString();
+  REQUIRE(PreciseTimePow<2>::fromChars(squared.data(), squared.data() + squared.size(), pt_squared).ec == std::errc());
+  REQUIRE(pt_squared.toDouble<s>() == 9.);
+  const std::string long_form = pt_0.toString();
+  REQUIRE(PreciseTimePow<2>::fromChars(long_form.data(), long_form.data() + long_form.size(), pt_squared).ec == std::errc::invalid_argument);
+  using PreciseTimeUs = BasicPreciseTime<us, TimeSpan<10, m>>;
+  PreciseTimeUs pt_us;
+  const std::string in_range = "599.9999999s";
+  REQUIRE(PreciseTimeUs::fromChars(in_range.data(), in_range.data() + in_range.size(), pt_us).ec == std::errc());
+  REQUIRE(pt_us == PreciseTimeUs(s(599) + ms(999) + us(999)));
+  const std::string out_of_range = "11m";
+  auto r = PreciseTimeUs::fromChars(out_of_range.data(), out_of_range.data() + out_of_range.size(), pt_us);
+  REQUIRE(r.ec == std::errc::result_out_of_range);
+  REQUIRE(r.ptr == out_of_range.data() + out_of_range.size());
+  REQUIRE(pt_us == PreciseTimeUs(s(599) + ms(999) + us(999)));
+
+  // errors leave the value unchanged
+  for (const std::string invalid : {"", "s", "-", "44.04", "44.04 s", "{h: [1]}^1", "+1s"}) {
+    pt = ns(7);
+    r  = PreciseTime::fromChars(invalid.data(), invalid.data() + invalid.size(), pt);
+    REQUIRE(r.ec == std::errc::invalid_argument);
+    REQUIRE(r.ptr == invalid.data());
+    REQUIRE(pt == PreciseTime(ns(7)));
+  }
+  const std::string trailing = "5mss";
+  r = PreciseTime::fromChars(trailing.data(), trailing.data() + trailing.size(), pt);
+  REQUIRE(r.ec == std::errc());
+  REQUIRE(r.ptr == trailing.data() + 3);
+  REQUIRE(pt == PreciseTime(ms(5)));
+  // NOLINTEND(readability-magic-numbers)
+}
+
 TEST_CASE("test_precise_time_class_better_than_double") {
 
   constexpr PreciseTime max              = PreciseTime::max();
@@ -335,3 +491,277 @@ TEST_CASE("test_precise_time_class_better_than_double") {
   REQUIRE(max_d_ns_minus_one_ns == max_minus_one_ns.toDouble<ns>());
   REQUIRE(max_d_ns == max_d_ns_minus_one_ns);
 }
+
+TEST_CASE("test_precise_time_64_backend") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  static_assert(sizeof(PreciseTime64) == sizeof(int64_t), "PreciseTime64 is a single int64_t");
+
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  constexpr PreciseTime64 max_pt = PreciseTime64::max();
+  constexpr std::array<int64_t, NUM_TESTS> expected_max_times = {
+    807L, 775L, 854L, 16L, 47L, 2562047L};
+  constexpr std::array<int64_t, NUM_TESTS> expected_min_times = {
+    -808L, -775L, -854L, -16L, -47L, -2562047L};
+  test_for_all_times(max_pt, expected_max_times);
+  test_for_all_times(PreciseTime64::min(), expected_min_times);
+  test_for_all_times(max_pt * 2, expected_max_times);
+  test_for_all_times(max_pt * -2, expected_min_times);
+  test_for_all_times(max_pt + max_pt, expected_max_times);
+  test_for_all_times(PreciseTime64(h(100000000)), expected_max_times);
+  REQUIRE(max_pt - ns(1) != max_pt);
+
+  constexpr PreciseTime64 pt_0 = ns(98788987654321);
+  test_for_all_times(pt_0, {321L, 654L, 987L, 28L, 26L, 27});
+
+  constexpr PreciseTime64 pt_1 = ns(321) - us(654) + ms(987) - s(28) + m(26) - h(27);
+  test_for_all_times(pt_1, {-679L, -653L, -13L, -27L, -34L, -26});
+
+  constexpr PreciseTime64 pt_2 = ns(8788987654321);
+  REQUIRE(pt_2 * 2 == pt_2 + pt_2);
+  REQUIRE(pt_2 * 0.125 == pt_2 / 8);
+
+  constexpr PreciseTime64 pt_3 = s(2);
+  const auto pt_4              = pt_3 * pt_3;
+  REQUIRE(pt_4.toDouble<s>() == 4);
+  REQUIRE(pt_4.getExponent() == 2);
+  REQUIRE(pt_4.getSqrt() == pt_3);
+
+  PreciseTime64 pt_5  = h(3);
+  pt_5               -= s(333);
+  REQUIRE(pt_5 == PreciseTime64(h(2)) + PreciseTime64(s(3600 - 333)));
+  REQUIRE(PreciseTime64(us(1)) < PreciseTime64(ns(5000)));
+
+  REQUIRE(PreciseTime64(ms(1) + us(1) + ns(1)).getTimeString(4) == "1.0010ms");
+  REQUIRE(PreciseTime64(s(1)).toString() ==
+          "{h: [0]   m: [0]   s: [1]   ms: [0]   us: [0]   ns: [0]}^1");
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_precise_time_resolution_and_span") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  using PreciseTimeUs = BasicPreciseTime<us, TimeSpan<10, m>>;
+  using PreciseTimeMs = BasicPreciseTime<ms, TimeSpan<24, h>>;
+  static_assert(std::is_same<PreciseTimeUs::rep, int32_t>::value, "10 minutes in us fit into int32_t");
+  static_assert(std::is_same<PreciseTimeMs::rep, int32_t>::value, "a day in ms fits into int32_t");
+  static_assert(std::is_same<PreciseTime64::rep, int64_t>::value, "PreciseTime64 is stored in int64_t");
+  static_assert(sizeof(PreciseTimeUs) == sizeof(int32_t), "PreciseTimeUs is a single int32_t");
+  static_assert(std::is_same<decltype(PreciseTimeUs() * PreciseTimeUs())::rep, int64_t>::value,
+                "the square of 10 minutes in us fits into int64_t");
+
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  constexpr PreciseTimeUs max_pt = PreciseTimeUs::max();
+  constexpr std::array<int64_t, NUM_TESTS> expected_max_times = {0L, 999L, 999L, 59L, 10L, 0L};
+  constexpr std::array<int64_t, NUM_TESTS> expected_min_times = {0L, -999L, -999L, -59L, -11L, 0L};
+  test_for_all_times(max_pt, expected_max_times);
+  test_for_all_times(PreciseTimeUs::min(), expected_min_times);
+  test_for_all_times(max_pt + max_pt, expected_max_times);
+  test_for_all_times(PreciseTimeUs::min() + PreciseTimeUs::min(), expected_min_times);
+  test_for_all_times(max_pt * 3, expected_max_times);
+  test_for_all_times(PreciseTimeUs(h(1)), expected_max_times);
+  test_for_all_times(PreciseTimeUs(ns(-3600000000000)), expected_min_times);
+  REQUIRE(max_pt.hasRolledOver());
+  REQUIRE(!(max_pt - us(1)).hasRolledOver());
+
+  // everything below the resolution is truncated
+  test_for_all_times(PreciseTimeUs(ns(1999)), {0L, 1L, 0L, 0L, 0L, 0L});
+  test_for_all_times(PreciseTimeUs(m(3) + s(2) - ms(1) + ns(10)), {0L, 0L, 999L, 1L, 3L, 0L});
+
+  constexpr PreciseTimeUs pt_0 = ms(10);
+  const auto pt_1              = pt_0 * pt_0;
+  REQUIRE(pt_1.getExponent() == 2);
+  REQUIRE(pt_1.toDouble<ns>() == 100000.);
+  REQUIRE(pt_1.getSqrt() == pt_0);
+  REQUIRE(pt_0 * 0.5 == pt_0 / 2);
+  REQUIRE(PreciseTimeUs(s(1)) / 3 == PreciseTimeUs(us(333333)));
+
+  const PreciseTimeMs pt_2 = h(13) + m(7) + ms(5) + us(999);
+  test_for_all_times(pt_2, {0L, 0L, 5L, 0L, 7L, 13L});
+  REQUIRE(pt_2.getTimeString(2) == "13.12h");
+  test_for_all_times(PreciseTimeMs::max(), {0L, 0L, 999L, 59L, 59L, 24L});
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_precise_time_column") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  using column_kernels::Isa;
+  constexpr int64_t max_ns = std::numeric_limits<int64_t>::max();
+  constexpr int64_t min_ns = std::numeric_limits<int64_t>::min();
+
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  PreciseTimeColumn column(std::vector<PreciseTime>{ns(5), ns(1), ns(7), ns(6), ns(8), ns(4), ns(2), ns(20)});
+  REQUIRE(column.size() == 8);
+  REQUIRE(column[7] == PreciseTime(ns(20)));
+  REQUIRE(column.sum() == PreciseTime(ns(53)));
+  REQUIRE(column.sum(ns(2), ns(7)) == PreciseTime(ns(24)));
+  REQUIRE(column.min() == PreciseTime(ns(1)));
+  REQUIRE(column.max() == PreciseTime(ns(20)));
+  REQUIRE(column.max(ns(0), ns(19)) == PreciseTime(ns(8)));
+  REQUIRE(column.min(ns(21), ns(30)) == PreciseTime::max());
+  REQUIRE(column.max(ns(21), ns(30)) == PreciseTime::min());
+  REQUIRE(column.countInRange(ns(2), ns(7)) == 5);
+  REQUIRE(column.sumOfSquares(ns(6)) == PreciseTime(ns(1)) * PreciseTime(ns(247)));
+  REQUIRE(column.toVector().size() == 8);
+  column.push_back(PreciseTime::max());
+  REQUIRE(column.max() == PreciseTime(ns(max_ns)));
+
+  // every SIMD kernel gives exactly the result of the scalar kernel
+  std::vector<Isa> isas = {column_kernels::bestIsa()};
+  if (isas[0] == Isa::AVX2) {
+    isas.push_back(Isa::SSE42);
+  }
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<int64_t> small(-1000000000, 5000000000);
+  std::uniform_int_distribution<int64_t> any(min_ns, max_ns);
+  for (const bool extreme : {false, true}) {
+    std::vector<int64_t> values(1003);
+    for (auto& value : values) {
+      value = extreme ? any(generator) : small(generator);
+    }
+    if (extreme) {
+      values[10] = max_ns;
+      values[11] = min_ns;
+    }
+    for (const auto& range : std::vector<std::pair<int64_t, int64_t>>{
+           {min_ns, max_ns}, {0, 2000000000}, {-5, -5}, {10, -10}}) {
+      for (const int64_t offset : {int64_t{0}, int64_t{1234567890}, min_ns}) {
+        for (size_t n : {size_t{0}, size_t{1}, size_t{7}, values.size()}) {
+          size_t count          = 0;
+          size_t expected_count = 0;
+          int64_t min_value     = 0;
+          int64_t max_value     = 0;
+          int64_t expected_min  = 0;
+          int64_t expected_max  = 0;
+          const auto expected_sum = column_kernels::sum(
+            values.data(), n, range.first, range.second, expected_count, Isa::SCALAR);
+          const auto expected_squares = column_kernels::sumOfSquares(
+            values.data(), n, offset, range.first, range.second, Isa::SCALAR);
+          column_kernels::minMax(
+            values.data(), n, range.first, range.second, expected_min, expected_max, Isa::SCALAR);
+          for (const Isa isa : isas) {
+            REQUIRE(column_kernels::sum(values.data(), n, range.first, range.second, count, isa) == expected_sum);
+            REQUIRE(count == expected_count);
+            REQUIRE(column_kernels::countInRange(values.data(), n, range.first, range.second, isa) == expected_count);
+            REQUIRE(column_kernels::sumOfSquares(values.data(), n, offset, range.first, range.second, isa) == expected_squares);
+            column_kernels::minMax(values.data(), n, range.first, range.second, min_value, max_value, isa);
+            REQUIRE(min_value == expected_min);
+            REQUIRE(max_value == expected_max);
+          }
+        }
+      }
+    }
+  }
+
+  // the scalar kernels are exact
+  const std::vector<int64_t> values = {max_ns, max_ns, min_ns, -3, 4000000000};
+  size_t count = 0;
+  REQUIRE(column_kernels::sum(values.data(), values.size(), min_ns, max_ns, count, Isa::SCALAR) ==
+          wide_int::int128(max_ns) + wide_int::int128(max_ns) + wide_int::int128(min_ns) + wide_int::int128(3999999997));
+  REQUIRE(count == values.size());
+  REQUIRE(column_kernels::sumOfSquares(values.data() + 3, 2, 1, min_ns, max_ns, Isa::SCALAR) ==
+          wide_int::int128(16) + wide_int::int128(3999999999) * wide_int::int128(3999999999));
+  REQUIRE(column_kernels::sumOfSquares(values.data(), values.size(), min_ns, min_ns, max_ns, Isa::SCALAR) ==
+          wide_int::limits<wide_int::int128>::max());
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_precise_time_accumulator") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  const std::vector<int64_t> small_values = {5, 1, 7, 6, 8, 4, 2, 20};
+  PreciseTimeAccumulator acc;
+  for (const int64_t value : small_values) {
+    acc.add(value);
+  }
+  REQUIRE(acc.getCount() == 8);
+  REQUIRE(acc.sum() == PreciseTime(ns(53)));
+  REQUIRE(acc.mean() == PreciseTime(ns(6)));
+  REQUIRE(acc.meanNanoseconds() == 6.625);
+  // sum (x - 6.625)^2 = 243.875, / 7 = 34.8...
+  REQUIRE(acc.variance() == PreciseTime(ns(1)) * PreciseTime(ns(34)));
+  REQUIRE(acc.standardDeviation() == PreciseTime(ns(5)));
+  REQUIRE(PreciseTimeAccumulator().mean() == PreciseTime::zero());
+  REQUIRE(PreciseTimeAccumulator().variance() == PreciseTimePow<2>::zero());
+
+  // one accumulator, the column kernels and merged partitions of any size
+  // give exactly the same result
+  std::mt19937_64 generator(7);
+  std::uniform_int_distribution<int64_t> durations(-100000000000, 4000000000000);
+  std::vector<int64_t> values(10007);
+  for (auto& value : values) {
+    value = durations(generator);
+  }
+  PreciseTimeAccumulator sequential;
+  for (const int64_t value : values) {
+    sequential.add(value);
+  }
+  const auto from_kernels = PreciseTimeAccumulator::fromNanoseconds(
+    values.data(), values.size(), std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+  REQUIRE(from_kernels.getCount() == sequential.getCount());
+  REQUIRE(from_kernels.sum() == sequential.sum());
+  REQUIRE(from_kernels.mean() == sequential.mean());
+  REQUIRE(from_kernels.variance() == sequential.variance());
+  REQUIRE(from_kernels.meanNanoseconds() == sequential.meanNanoseconds());
+
+  std::shuffle(values.begin(), values.end(), generator);
+  for (const size_t num_parts : {size_t{2}, size_t{3}, size_t{16}, size_t{1000}}) {
+    PreciseTimeAccumulator merged;
+    const size_t part_size = (values.size() + num_parts - 1) / num_parts;
+    for (size_t begin = 0; begin < values.size(); begin += part_size) {
+      const size_t n = std::min(part_size, values.size() - begin);
+      merged.merge(PreciseTimeAccumulator::fromNanoseconds(
+        values.data() + begin, n, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()));
+    }
+    REQUIRE(merged.getCount() == sequential.getCount());
+    REQUIRE(merged.sum() == sequential.sum());
+    REQUIRE(merged.variance() == sequential.variance());
+    REQUIRE(merged.meanNanoseconds() == sequential.meanNanoseconds());
+  }
+
+  // only values in range
+  const auto in_range = PreciseTimeAccumulator::fromNanoseconds(small_values.data(), small_values.size(), 0, 10);
+  REQUIRE(in_range.getCount() == 7);
+  REQUIRE(in_range.mean() == PreciseTime(ns(4)));
+
+  PreciseTimeAccumulator huge;
+  huge.add(std::numeric_limits<int64_t>::min());
+  huge.add(std::numeric_limits<int64_t>::max());
+  huge.add(std::numeric_limits<int64_t>::max());
+  REQUIRE(huge.variance() == PreciseTimePow<2>::max());
+  REQUIRE(huge.sum() == PreciseTime(ns(std::numeric_limits<int64_t>::max())) - PreciseTime(ns(1)));
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_wide_int_emulation") {
+  using wide_int::Int128;
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  constexpr Int128 a = Int128(3600000000000LL) * Int128(std::numeric_limits<int64_t>::max());
+  constexpr Int128 b = Int128(-987654321987LL);
+
+  REQUIRE(a / Int128(3600000000000LL) == Int128(std::numeric_limits<int64_t>::max()));
+  REQUIRE(a % Int128(3600000000000LL) == Int128(0));
+  REQUIRE((a + b) - a == b);
+  REQUIRE(b * b / b == b);
+  REQUIRE((a - Int128(7)) % Int128(1000) == Int128(-7 + 1000 * 1000) % Int128(1000));
+  REQUIRE(Int128(-7) / Int128(2) == Int128(-3));
+  REQUIRE(Int128(-7) % Int128(2) == Int128(-1));
+  REQUIRE(b < Int128(0));
+  REQUIRE(a > b);
+  REQUIRE(static_cast<double>(b) == -987654321987.);
+  constexpr Int128 two_pow_50 = Int128(int64_t{1} << 50U);
+  REQUIRE(Int128::fromDouble(-0x3p100) == Int128(-3) * two_pow_50 * two_pow_50);
+  REQUIRE(static_cast<double>(wide_int::limits<Int128>::min()) == -0x1p127);
+
+  int64_t mantissa = 0;
+  int shift        = 0;
+  REQUIRE(wide_int::toDyadic(-0.375, mantissa, shift));
+  REQUIRE(mantissa == -3);
+  REQUIRE(shift == 3);
+  REQUIRE(!wide_int::toDyadic(1e300, mantissa, shift));
+  REQUIRE(!wide_int::toDyadic(1e-300, mantissa, shift));
+  static_assert(
+    [] {
+      int64_t mant = 0;
+      int sh       = 0;
+      return wide_int::toDyadic(-0.375, mant, sh) && mant == -3 && sh == 3;
+    }(),
+    "toDyadic works at compile time");
+  REQUIRE(wide_int::divPow2(int64_t{-7}, 1) == -3);
+  REQUIRE(wide_int::divPow2(Int128(-7), 1) == Int128(-3));
+  // NOLINTEND(readability-magic-numbers)
+}
@@ -1,6 +1,8 @@
 /**
  * @file test_timings.cpp
- * @brief contains the unit tests using catch2 for the timer classes: CollectingTimer, FrameTimer
+ * @brief contains the unit tests using catch2 for the timer classes: CollectingTimer,
+ * ConcurrentCollectingTimer, FrameTimer, LogLinearHistogram
+ * and the clock policies they are templated on
  *
  * @date 30.08.2025
  * @author Jakob Wandel
@@ -10,16 +12,31 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_message.hpp>
 
+#include <timer/call_tree_timer.hpp>
+#include <timer/capture_file.hpp>
+#include <timer/clock.hpp>
 #include <timer/collecting_timer.hpp>
+#include <timer/compressed_column.hpp>
+#include <timer/concurrent_collecting_timer.hpp>
+#include <timer/exporter.hpp>
 #include <timer/frame_timer.hpp>
+#include <timer/log_linear_histogram.hpp>
+#include <timer/precise_time_accumulator.hpp>
 #include <timer/precise_time.hpp>
+#include <timer/simple_timer.hpp>
 
 #include <algorithm>
 #include <array>
 #include <chrono>
 #include <cmath>
 #include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using ns = std::chrono::nanoseconds;
@@ -220,3 +237,1345 @@ TEST_CASE("test_FrameTimer") {
 
   REQUIRE(erg[0] == 0);
 }
+
+TEST_CASE("test_timer_measurements_round_trip") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  const std::vector<PreciseTime> a_times = {ns(5), us(1) + ns(1), ms(7), s(6) + ns(8), ns(4)};
+  const std::vector<PreciseTime> b_times = {ms(20), us(3)};
+  CollectingTimer t_0(a_times, "a");
+
+  const std::string file_name = "test_timer_measurements_round_trip.csv";
+  std::remove(file_name.c_str());
+  t_0.measurementsToFile<us>(file_name, ',');
+
+  std::vector<std::string> names;
+  std::vector<std::vector<PreciseTime>> columns;
+  REQUIRE(CollectingTimer::measurementsFromFile<us>(file_name, ',', names, columns));
+  std::remove(file_name.c_str());
+  REQUIRE(names == std::vector<std::string>{"a"});
+  REQUIRE(columns.size() == 1);
+  REQUIRE(columns[0] == a_times);
+
+  // several columns of different length, empty fields are skipped
+  const std::string csv = "a;b\r\n0.005;20000.000000\r\n1.001000; 3\r\n7000;\n6000000.008;\n0.004;";
+  REQUIRE(CollectingTimer::measurementsFromChars<us>(csv.data(), csv.data() + csv.size(), ';', names, columns));
+  REQUIRE(names == std::vector<std::string>{"a", "b"});
+  REQUIRE(columns[0] == a_times);
+  REQUIRE(columns[1] == b_times);
+
+  // the columns feed a CollectingTimer and give the same results
+  CollectingTimer t_1(std::move(columns[0]), names[0]);
+  CollectingTimer::Result r_0;
+  CollectingTimer::Result r_1;
+  t_0.getResult("a", r_0);
+  t_1.getResult("a", r_1);
+  test_for_result(r_1, r_0, __LINE__);
+
+  const std::string invalid = "a\n1.0\nx\n";
+  REQUIRE(!CollectingTimer::measurementsFromChars<us>(invalid.data(), invalid.data() + invalid.size(), ',', names, columns));
+  const std::string too_many_fields = "a\n1.0,2.0\n";
+  REQUIRE(!CollectingTimer::measurementsFromChars<us>(too_many_fields.data(), too_many_fields.data() + too_many_fields.size(), ',', names, columns));
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_clock_policies") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  const auto& calibration = TscClock::calibrate();
+  REQUIRE(calibration.tsc == TscClock::usesTsc());
+  if (calibration.tsc) {
+    // a counter between 100 MHz and 10 GHz
+    REQUIRE(calibration.ticksPerSecond() > 1e8);
+    REQUIRE(calibration.ticksPerSecond() < 1e10);
+  } else {
+    // fallback: the ticks are steady clock nanoseconds
+    REQUIRE(TscClock::toNanoseconds(123456789) == 123456789);
+  }
+  std::vector<int64_t> ticks = {0, 1, -1, 1000, -1000, 123456789};
+  std::vector<int64_t> nanos = ticks;
+  TscClock::toNanoseconds(nanos.data(), nanos.data() + nanos.size());
+  for (size_t i = 0; i < ticks.size(); ++i) {
+    REQUIRE(nanos[i] == TscClock::toNanoseconds(ticks[i]));
+    REQUIRE(TscClock::toPreciseTime(ticks[i]) == PreciseTime(ns(nanos[i])));
+  }
+
+  // the counter measures the same as the steady clock
+  BasicSingleTimer<SteadyClock> steady;
+  BasicSingleTimer<TscClock> tsc;
+  steady.start();
+  tsc.start();
+  std::this_thread::sleep_for(ms(10));
+  const auto tsc_time    = tsc.getPassedTime<us>();
+  const auto steady_time = steady.getPassedTime<us>();
+  REQUIRE(tsc_time >= ms(10) - us(100));
+  REQUIRE(tsc_time <= steady_time + us(100));
+
+  // measurements are stored in ticks and converted once, when the results
+  // are requested: given measurements are nanoseconds already
+  const std::vector<PreciseTime> given = {us(1), us(2), us(3), us(4)};
+  BasicCollectingTimer<TscClock> timer(given, "a");
+  BasicCollectingTimer<TscClock>::Result r;
+  REQUIRE(timer.getResult("a", r));
+  REQUIRE(r.min_measurement == us(1));
+  REQUIRE(r.max_measurement == us(4));
+  for (int i = 0; i < 3; ++i) {
+    timer.start("a");
+    std::this_thread::sleep_for(ms(1));
+    timer.stop("a");
+    REQUIRE(timer.getResult("a", r, false));
+    REQUIRE(r.min_measurement == us(1));
+    REQUIRE(r.number_measurements == given.size() + static_cast<size_t>(i) + 1);
+  }
+  REQUIRE(r.max_measurement >= ms(1) - us(100));
+  REQUIRE(r.max_measurement < s(1));
+
+  BasicFrameTimer<TscClock> frame_timer;
+  for (int i = 0; i < 3; ++i) {
+    frame_timer.frameStart();
+    const auto scoped_timer = frame_timer.startScopedTimer("frame");
+  }
+  frame_timer.frameStop();
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_timer_ids") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  CollectingTimer timer;
+  const CollectingTimer::TimerId a = timer.registerTimer("a");
+  const CollectingTimer::TimerId b = timer.registerTimer(std::string("b"));
+  REQUIRE(a != b);
+  REQUIRE(timer.registerTimer("a") == a);
+  timer.reserve(a, 10);
+  timer.reserve(b, 10);
+
+  // stop without start is ignored, as are unknown handles
+  timer.stop(a);
+  timer.stop("b");
+  timer.stop("c");
+  timer.start(b + 100);
+  timer.stop(b + 100);
+
+  // the name and the handle address the same timer
+  for (int i = 0; i < 5; ++i) {
+    timer.start(a);
+    timer.stop(a);
+    timer.start("a");
+    timer.stop(a);
+  }
+  timer.start("b");
+  timer.stop(b);
+
+  CollectingTimer::Result r;
+  REQUIRE(timer.getResult("a", r));
+  REQUIRE(r.number_measurements == 10);
+  REQUIRE(!timer.getResult("b", r));
+  REQUIRE(r.number_measurements == 1);
+  REQUIRE(!timer.getResult("c", r));
+
+  // registered timers without measurements are not written
+  timer.registerTimer("d");
+  const std::string file_name = "test_timer_ids.csv";
+  std::remove(file_name.c_str());
+  timer.measurementsToFile<us>(file_name, ',');
+  std::vector<std::string> names;
+  std::vector<std::vector<PreciseTime>> columns;
+  REQUIRE(CollectingTimer::measurementsFromFile<us>(file_name, ',', names, columns));
+  std::remove(file_name.c_str());
+  REQUIRE(names == std::vector<std::string>{"a", "b"});
+  REQUIRE(columns[0].size() == 10);
+  REQUIRE(columns[1].size() == 1);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_concurrent_timer") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  constexpr size_t NUM_THREADS = 8;
+  constexpr size_t NUM_PAIRS   = 1000;
+  ConcurrentCollectingTimer timer;
+  const ConcurrentCollectingTimer::TimerId shared = timer.registerTimer("shared");
+  std::vector<ConcurrentCollectingTimer::TimerId> own;
+  for (size_t t = 0; t < NUM_THREADS; ++t) {
+    own.push_back(timer.registerTimer("thread " + std::to_string(t)));
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < NUM_THREADS; ++t) {
+    threads.emplace_back([&timer, shared, &own, t]() {
+      timer.reserve(shared, NUM_PAIRS);
+      // a stop without start in this thread is ignored
+      timer.stop(own[t]);
+      for (size_t i = 0; i < NUM_PAIRS; ++i) {
+        timer.start(shared);
+        timer.start(own[t]);
+        timer.stop(own[t]);
+        timer.stop(shared);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ConcurrentCollectingTimer::Result r;
+  REQUIRE(timer.getResult("shared", r));
+  REQUIRE(r.number_measurements == NUM_THREADS * NUM_PAIRS);
+  for (size_t t = 0; t < NUM_THREADS; ++t) {
+    REQUIRE(timer.getResult("thread " + std::to_string(t), r));
+    REQUIRE(r.number_measurements == NUM_PAIRS);
+  }
+
+  // a thread which is not attached records nothing
+  timer.start(shared);
+  timer.stop(shared);
+  REQUIRE(timer.getResult("shared", r));
+  REQUIRE(r.number_measurements == NUM_THREADS * NUM_PAIRS);
+
+  // measurements after a merge are added to the merged ones, also from a
+  // timer registered after the thread buffer was created
+  timer.attachThread();
+  const ConcurrentCollectingTimer::TimerId late = timer.registerTimer("late");
+  timer.start(late);
+  timer.stop(late);
+  REQUIRE(!timer.getResult("late", r));
+  REQUIRE(r.number_measurements == 0);
+  timer.attachThread();
+  timer.start(late);
+  timer.stop(late);
+  timer.start(shared);
+  timer.stop(shared);
+  timer.start(late + 100);
+  timer.stop(late + 100);
+  REQUIRE(timer.getResult("shared", r));
+  REQUIRE(r.number_measurements == NUM_THREADS * NUM_PAIRS + 1);
+  REQUIRE(!timer.getResult("late", r));
+  REQUIRE(r.number_measurements == 1);
+
+  // a measurement survives while the thread attaches to other instances
+  // which are destroyed, e.g. the scratch instances of calibrateOverhead()
+  timer.start(late);
+  for (size_t i = 0; i < 20; ++i) {
+    timer.calibrateOverhead(3);
+  }
+  timer.stop(late);
+  timer.setOverhead(PreciseTime());
+  REQUIRE(!timer.getResult("late", r));
+  REQUIRE(r.number_measurements == 2);
+
+  const std::string file_name = "test_concurrent_timer.csv";
+  std::remove(file_name.c_str());
+  timer.measurementsToFile<us>(file_name, ',');
+  std::vector<std::string> names;
+  std::vector<std::vector<PreciseTime>> columns;
+  REQUIRE(CollectingTimer::measurementsFromFile<us>(file_name, ',', names, columns));
+  std::remove(file_name.c_str());
+  REQUIRE(names.size() == NUM_THREADS + 2);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_streaming_timer") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  const std::vector<PreciseTime> times = {ns(5), us(1) + ns(1), ms(7), s(6) + ns(8), ns(4), us(3)};
+  PreciseTimeAccumulator accumulator;
+  for (const auto& time : times) {
+    accumulator.add(time);
+  }
+
+  // switching a timer to STREAMING folds its samples into the statistics
+  CollectingTimer timer(times, "a");
+  const CollectingTimer::TimerId a = timer.registerTimer("a");
+  timer.setStorage(a, CollectingTimer::Storage::STREAMING);
+  CollectingTimer::Result r;
+  REQUIRE(timer.getResult("a", r));
+  REQUIRE(r.number_measurements == times.size());
+  REQUIRE(r.mean == accumulator.mean());
+  REQUIRE(r.standard_derivation == accumulator.standardDeviation());
+  REQUIRE(r.min_measurement == ns(4));
+  REQUIRE(r.max_measurement == s(6) + ns(8));
+  REQUIRE(r.h.buckets.empty());
+
+  // STREAMING timers are not written as measurements
+  const std::string file_name = "test_streaming_timer.csv";
+  std::remove(file_name.c_str());
+  REQUIRE(!timer.measurementsToFile<us>(file_name, ','));
+  std::remove(file_name.c_str());
+
+  // per instance, with a SAMPLES timer next to it
+  CollectingTimer streaming(CollectingTimer::Storage::STREAMING);
+  const CollectingTimer::TimerId b = streaming.registerTimer("b");
+  const CollectingTimer::TimerId c =
+    streaming.registerTimer("c", CollectingTimer::Storage::SAMPLES);
+  for (int i = 0; i < 100; ++i) {
+    streaming.start(b);
+    streaming.stop(b);
+    streaming.start(c);
+    streaming.stop(c);
+  }
+  CollectingTimer::Result r_b;
+  CollectingTimer::Result r_c;
+  REQUIRE(streaming.getResult("b", r_b));
+  REQUIRE(streaming.getResult("c", r_c));
+  REQUIRE(r_b.number_measurements == 100);
+  REQUIRE(r_c.number_measurements == 100);
+  REQUIRE(r_b.min_measurement <= r_b.mean);
+  REQUIRE(r_b.mean <= r_b.max_measurement);
+  REQUIRE(!r_c.h.buckets.empty());
+
+  // back to SAMPLES drops the statistics
+  streaming.setStorage(b, CollectingTimer::Storage::SAMPLES);
+  REQUIRE(!streaming.getResult("b", r_b));
+  REQUIRE(r_b.number_measurements == 0);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_log_linear_histogram") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  for (int digits = 1; digits <= LogLinearHistogram::MAX_SIGNIFICANT_DIGITS; ++digits) {
+    const LogLinearHistogram histogram(digits);
+    double max_error = 1.;
+    for (int d = 0; d < digits; ++d) {
+      max_error /= 10.;
+    }
+    // every value lies in its bucket and the bucket is narrow enough
+    std::vector<int64_t> values = {0, 1, 2, 3, 1000, 1023, 1024, 123456789, std::numeric_limits<int64_t>::max()};
+    for (int64_t v = 1; v < std::numeric_limits<int64_t>::max() / 3; v *= 3) {
+      values.push_back(v);
+      values.push_back(v + 1);
+    }
+    for (const int64_t value : values) {
+      const size_t index = histogram.indexOf(value);
+      INFO("digits " + std::to_string(digits) + " value " + std::to_string(value));
+      REQUIRE(index < histogram.numBuckets());
+      REQUIRE(histogram.lowestAt(index) <= value);
+      REQUIRE(value <= histogram.highestAt(index));
+      if (value > histogram.getHighestTrackable()) {
+        // counted in the open ended last bucket
+        REQUIRE(index + 1 == histogram.numBuckets());
+        continue;
+      }
+      const auto width = static_cast<double>(histogram.highestAt(index) - histogram.lowestAt(index));
+      REQUIRE(width <= std::max(1., static_cast<double>(histogram.lowestAt(index))) * max_error);
+    }
+    REQUIRE(histogram.indexOf(-5) == 0);
+  }
+
+  // the memory is bounded by the range, not by int64_t max
+  REQUIRE(LogLinearHistogram(3).numBuckets() * sizeof(uint64_t) < 300'000);
+  const LogLinearHistogram finest(LogLinearHistogram::MAX_SIGNIFICANT_DIGITS);
+  REQUIRE(finest.getSignificantDigits() == 5);
+  REQUIRE(finest.numBuckets() * sizeof(uint64_t) < 30'000'000);
+  const LogLinearHistogram one_second(2, 1'000'000'000);
+  REQUIRE(one_second.numBuckets() < LogLinearHistogram(2).numBuckets());
+  REQUIRE(one_second.highestAt(one_second.indexOf(1'000'000'000)) >= 1'000'000'000);
+  REQUIRE(one_second.indexOf(1'000'000'000) + 1 < one_second.numBuckets());
+
+  // buckets are contiguous
+  const LogLinearHistogram layout(2);
+  for (size_t i = 1; i < layout.numBuckets() && layout.highestAt(i - 1) < std::numeric_limits<int64_t>::max(); ++i) {
+    REQUIRE(layout.lowestAt(i) == layout.highestAt(i - 1) + 1);
+  }
+
+  // quantiles within the relative error, merging equals recording into one
+  std::mt19937_64 generator(42);  // NOLINT fixed seed for repeatable runs
+  std::lognormal_distribution<double> durations(10., 1.5);
+  std::vector<int64_t> samples;
+  LogLinearHistogram all(3);
+  LogLinearHistogram first_half(3);
+  LogLinearHistogram second_half(3);
+  for (size_t i = 0; i < 10000; ++i) {
+    samples.push_back(static_cast<int64_t>(durations(generator)));
+    all.record(samples.back());
+    (i % 2 == 0 ? first_half : second_half).record(samples.back());
+  }
+  REQUIRE(first_half.merge(second_half));
+  REQUIRE(!first_half.merge(LogLinearHistogram(2)));
+  REQUIRE(!first_half.merge(LogLinearHistogram(3, 1'000'000)));
+  REQUIRE(first_half.getTotalCount() == samples.size());
+  std::sort(samples.begin(), samples.end());
+  for (const double q : {0.01, 0.5, 0.9, 0.99, 0.999, 1.}) {
+    const auto rank  = static_cast<size_t>(std::ceil(q * static_cast<double>(samples.size())));
+    const auto exact = static_cast<double>(samples[rank - 1]);
+    const double estimate = all.quantile(q).toDouble<ns>();
+    REQUIRE(std::abs(estimate - exact) <= exact * 1e-3);
+    REQUIRE(first_half.quantile(q) == all.quantile(q));
+  }
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_histogram_timer") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  std::vector<PreciseTime> times;
+  for (int i = 1; i <= 1001; ++i) {
+    times.emplace_back(us(i));
+  }
+  PreciseTimeAccumulator accumulator;
+  for (const auto& time : times) {
+    accumulator.add(time);
+  }
+
+  CollectingTimer timer(times, "a");
+  const CollectingTimer::TimerId a = timer.registerTimer("a");
+  timer.setStorage(a, CollectingTimer::Storage::HISTOGRAM, 3);
+  CollectingTimer::Result r;
+  REQUIRE(timer.getResult("a", r));
+  REQUIRE(r.number_measurements == times.size());
+  REQUIRE(r.mean == accumulator.mean());
+  REQUIRE(r.min_measurement == us(1));
+  REQUIRE(r.max_measurement == us(1001));
+  REQUIRE(std::abs(r.median.toDouble<ns>() - 501000.) <= 501.);
+  REQUIRE(!r.h.buckets.empty());
+  REQUIRE(r.h.buckets.front().begin <= us(1));
+  REQUIRE(PreciseTime(us(1001)) < r.h.buckets.back().end);
+  int num = 0;
+  for (const auto& bucket : r.h.buckets) {
+    num += bucket.num;
+  }
+  REQUIRE(num == 1001);
+
+  // rendered by the existing paths
+  std::stringstream stream;
+  stream << r;
+  REQUIRE(stream.str().find('#') != std::string::npos);
+  const std::string file_name = "test_histogram_timer.csv";
+  std::remove(file_name.c_str());
+  REQUIRE(!timer.histogramToFile<us>(file_name, ','));
+  std::ifstream file(file_name);
+  std::string header;
+  std::getline(file, header);
+  file.close();
+  std::remove(file_name.c_str());
+  REQUIRE(header == "a bucket,a count");
+
+  CollectingTimer instance(CollectingTimer::Storage::HISTOGRAM);
+  const CollectingTimer::TimerId b = instance.registerTimer("b");
+  for (int i = 0; i < 100; ++i) {
+    instance.start(b);
+    instance.stop(b);
+  }
+  REQUIRE(instance.getResult("b", r));
+  REQUIRE(r.number_measurements == 100);
+  REQUIRE(r.min_measurement <= r.median);
+  REQUIRE(r.median <= r.max_measurement);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_result_quantiles") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  std::mt19937_64 generator(7);  // NOLINT fixed seed for repeatable runs
+  std::lognormal_distribution<double> durations(12., 1.);
+  std::vector<PreciseTime> times;
+  std::vector<int64_t> sorted;
+  for (size_t i = 0; i < 20000; ++i) {
+    sorted.push_back(static_cast<int64_t>(durations(generator)));
+    times.emplace_back(ns(sorted.back()));
+  }
+  std::sort(sorted.begin(), sorted.end());
+  const std::vector<double> qs = {0.5, 0.9, 0.99, 0.999, 0., 1.};
+
+  // from the samples and from a HISTOGRAM timer with 3 significant digits
+  CollectingTimer samples(times, "a");
+  CollectingTimer histogram(times, "a");
+  histogram.setStorage(histogram.registerTimer("a"), CollectingTimer::Storage::HISTOGRAM, 3);
+  for (CollectingTimer* timer : {&samples, &histogram}) {
+    CollectingTimer::Result r;
+    REQUIRE(timer->getResult("a", r));
+    REQUIRE(r.sketch.has_value());
+    double relative_error = 1.;
+    for (int d = 0; d < r.sketch->getSignificantDigits(); ++d) {
+      relative_error /= 10.;
+    }
+    const std::vector<PreciseTime> values = r.quantiles(qs);
+    REQUIRE(values.size() == qs.size());
+    for (size_t i = 0; i < qs.size(); ++i) {
+      const size_t rank = std::max<size_t>(
+        1, static_cast<size_t>(std::ceil(qs[i] * static_cast<double>(sorted.size()))));
+      const auto exact = static_cast<double>(sorted[rank - 1]);
+      INFO("quantile " + std::to_string(qs[i]));
+      REQUIRE(std::abs(values[i].toDouble<ns>() - exact) <= exact * relative_error);
+      REQUIRE(values[i] == r.quantile(qs[i]));
+    }
+    REQUIRE(r.quantile(0.) == ns(sorted.front()));
+    REQUIRE(r.quantile(1.) == ns(sorted.back()));
+  }
+
+  // sketches of partial results merge
+  CollectingTimer first(std::vector<PreciseTime>(times.begin(), times.begin() + 10000), "a");
+  CollectingTimer second(std::vector<PreciseTime>(times.begin() + 10000, times.end()), "a");
+  CollectingTimer::Result r_all;
+  CollectingTimer::Result r_first;
+  CollectingTimer::Result r_second;
+  REQUIRE(samples.getResult("a", r_all));
+  REQUIRE(first.getResult("a", r_first));
+  REQUIRE(second.getResult("a", r_second));
+  REQUIRE(r_first.sketch->merge(*r_second.sketch));
+  REQUIRE(r_first.sketch->quantiles(qs) == r_all.sketch->quantiles(qs));
+
+  // no sketch without samples or histogram
+  CollectingTimer streaming(times, "a");
+  streaming.setStorage(streaming.registerTimer("a"), CollectingTimer::Storage::STREAMING);
+  CollectingTimer::Result r;
+  REQUIRE(streaming.getResult("a", r));
+  REQUIRE(!r.sketch.has_value());
+  REQUIRE(r.quantile(0.99) == PreciseTime::zero());
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_histogram_binning") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  constexpr size_t NUM_VALUES = size_t{1} << 20U;
+  std::mt19937_64 generator(3);  // NOLINT fixed seed for repeatable runs
+  std::uniform_int_distribution<int64_t> durations(1000, 2000);
+  std::vector<PreciseTime> times;
+  times.reserve(NUM_VALUES);
+  for (size_t i = 0; i < NUM_VALUES; ++i) {
+    times.emplace_back(ns(durations(generator)));
+  }
+  const PreciseTimeColumn column(times);
+  std::vector<bool> skip(NUM_VALUES, false);
+  for (size_t i = 0; i < NUM_VALUES; i += 7) {
+    skip[i] = true;
+  }
+
+  // the bucket scan the index computation replaces: the first bucket
+  // containing the value, borders included
+  CollectingTimer::Histogram expected;
+  expected.initBuckets(ns(7), ns(1000), ns(1950));
+  for (size_t i = 0; i < NUM_VALUES; ++i) {
+    if (skip[i]) {
+      continue;
+    }
+    for (auto& bucket : expected.buckets) {
+      if (bucket.begin <= times[i] && times[i] <= bucket.end) {
+        bucket.num++;
+        break;
+      }
+    }
+  }
+  for (const auto& bucket : expected.buckets) {
+    expected.max_num_in_bucket = std::max(expected.max_num_in_bucket, bucket.num);
+  }
+
+  for (const size_t max_threads : {size_t{1}, size_t{3}, size_t{4}}) {
+    CollectingTimer::Histogram histogram;
+    histogram.initBuckets(ns(7), ns(1000), ns(1950));
+    histogram.fillBuckets(column.begin(), NUM_VALUES, skip, max_threads);
+    test_for_Histogram(histogram, expected, __LINE__);
+  }
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_fused_statistics") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  std::mt19937_64 generator(11);  // NOLINT fixed seed for repeatable runs
+  std::normal_distribution<double> durations(1e6, 1e4);
+  for (const size_t num_values : {size_t{3}, size_t{2047}, size_t{100001}}) {
+    std::vector<PreciseTime> times;
+    for (size_t i = 0; i < num_values; ++i) {
+      times.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+    }
+    // a few far outliners, also in the first value which is the offset
+    times[0]              = ms(50);
+    times[num_values / 2] = ns(3);
+    times.back()          = s(7);
+
+    CollectingTimer timer(times, "a");
+    CollectingTimer::Result r;
+    REQUIRE(timer.getResult("a", r, false));
+
+    // the passes over all measurements the fused kernel replaces
+    const PreciseTimeColumn column(times);
+    auto acc = PreciseTimeAccumulator::fromColumn(column, PreciseTime::min(), PreciseTime::max());
+    PreciseTime lo = PreciseTime::min();
+    PreciseTime hi = PreciseTime::max();
+    size_t num_outliners = 0;
+    if (acc.standardDeviation() > PreciseTime(ns(1))) {
+      const auto dev_range = acc.standardDeviation() * r.outliner_range;
+      lo                   = acc.mean() - dev_range;
+      hi                   = acc.mean() + dev_range;
+      num_outliners        = num_values - column.countInRange(lo, hi);
+      acc                  = PreciseTimeAccumulator::fromColumn(column, lo, hi);
+    }
+    INFO("number of values " + std::to_string(num_values));
+    REQUIRE(r.mean == acc.mean());
+    REQUIRE(r.standard_derivation == acc.standardDeviation());
+    REQUIRE(r.min_measurement == column.min(lo, hi));
+    REQUIRE(r.max_measurement == column.max(lo, hi));
+    REQUIRE(r.number_outliners == num_outliners);
+    for (size_t i = 0; i < num_values; ++i) {
+      REQUIRE(r.is_outliner[i] == (times[i] < lo || hi < times[i]));
+    }
+  }
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_parallel_results") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  std::mt19937_64 generator(17);  // NOLINT fixed seed for repeatable runs
+  std::lognormal_distribution<double> durations(13., 0.5);
+  // large enough to be split into chunks on 4 threads
+  std::vector<PreciseTime> times;
+  for (size_t i = 0; i < (size_t{1} << 20U) + 3; ++i) {
+    times.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+  }
+  CollectingTimer timer(times, "large");
+  for (const std::string name : {"small b", "small a", "small c"}) {
+    for (int i = 0; i < 50; ++i) {
+      timer.start(name);
+      timer.stop(name);
+    }
+  }
+  const auto streaming = timer.registerTimer("streaming", CollectingTimer::Storage::STREAMING);
+  for (int i = 0; i < 50; ++i) {
+    timer.start(streaming);
+    timer.stop(streaming);
+  }
+  timer.start("too few");
+  timer.stop("too few");
+
+  auto requireEqual = [](const CollectingTimer::Result& a, const CollectingTimer::Result& b) {
+    INFO(a.timer_name);
+    REQUIRE(a.timer_name == b.timer_name);
+    REQUIRE(a.number_measurements == b.number_measurements);
+    REQUIRE(a.number_outliners == b.number_outliners);
+    REQUIRE(a.mean == b.mean);
+    REQUIRE(a.median == b.median);
+    REQUIRE(a.standard_derivation == b.standard_derivation);
+    REQUIRE(a.min_measurement == b.min_measurement);
+    REQUIRE(a.max_measurement == b.max_measurement);
+    REQUIRE(a.is_outliner == b.is_outliner);
+    REQUIRE(a.h.buckets.size() == b.h.buckets.size());
+    for (size_t i = 0; i < a.h.buckets.size(); ++i) {
+      REQUIRE(a.h.buckets[i].num == b.h.buckets[i].num);
+    }
+    REQUIRE(a.sketch.has_value() == b.sketch.has_value());
+    if (a.sketch) {
+      const std::vector<double> qs = {0., 0.5, 0.9, 0.99, 0.999, 1.};
+      REQUIRE(a.quantiles(qs) == b.quantiles(qs));
+    }
+  };
+
+  // no threads are started unless asked for
+  REQUIRE(timer.getReportThreads() == 1);
+  const auto sequential = timer.getResults(false);
+  timer.setReportThreads(4);
+  const auto parallel = timer.getResults(false);
+
+  // sorted by name, independent of the number of threads
+  const std::vector<std::string> names = {
+    "large", "small a", "small b", "small c", "streaming", "too few"};
+  REQUIRE(sequential.size() == names.size());
+  REQUIRE(parallel.size() == names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    REQUIRE(sequential[i].timer_name == names[i]);
+    requireEqual(sequential[i], parallel[i]);
+  }
+
+  // a single large timer is split into chunks
+  CollectingTimer::Result large;
+  REQUIRE(timer.getResult("large", large, false));
+  requireEqual(sequential[0], large);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_percentiles") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  std::mt19937_64 generator(23);  // NOLINT fixed seed for repeatable runs
+  std::lognormal_distribution<double> durations(10., 1.);
+  std::vector<PreciseTime> times;
+  for (size_t i = 0; i < 1000; ++i) {
+    times.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+  }
+  CollectingTimer timer(times, "a");
+
+  // linear interpolation between the closest ranks of a sorted copy
+  auto expected = [](std::vector<PreciseTime> values, double percent) {
+    std::sort(values.begin(), values.end());
+    const double position = percent / 100. * static_cast<double>(values.size() - 1);
+    const auto lower      = static_cast<size_t>(position);
+    const size_t upper    = std::min(lower + 1, values.size() - 1);
+    return values[lower] + (values[upper] - values[lower]) * (position - static_cast<double>(lower));
+  };
+
+  // the measurements as recorded, read back from file
+  auto recorded = [&timer]() {
+    const std::string file_name = "test_percentiles.csv";
+    std::remove(file_name.c_str());
+    timer.measurementsToFile<ns>(file_name, ',');
+    std::vector<std::string> names;
+    std::vector<std::vector<PreciseTime>> columns;
+    REQUIRE(CollectingTimer::measurementsFromFile<ns>(file_name, ',', names, columns));
+    std::remove(file_name.c_str());
+    return columns.at(0);
+  };
+
+  const std::vector<double> percents = {99.9, 0., 50., 25., 90., 99., 100., 33.3};
+  std::vector<PreciseTime> percentiles;
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    REQUIRE(timer.getPercentiles("a", percents, percentiles));
+    REQUIRE(percentiles.size() == percents.size());
+    for (size_t i = 0; i < percents.size(); ++i) {
+      INFO("percentile " + std::to_string(percents[i]));
+      REQUIRE(percentiles[i] == expected(times, percents[i]));
+    }
+  }
+  REQUIRE(percentiles[1] == *std::min_element(times.begin(), times.end()));
+  REQUIRE(percentiles[6] == *std::max_element(times.begin(), times.end()));
+
+  // the median of getResult matches the 50th percentile, also once the
+  // sorted view is behind the measurements
+  CollectingTimer::Result r;
+  REQUIRE(timer.getResult("a", r, true));
+  REQUIRE(r.median == percentiles[2]);
+  for (int i = 0; i < 3; ++i) {
+    timer.start("a");
+    timer.stop("a");
+  }
+  const std::vector<PreciseTime> all = recorded();
+  REQUIRE(all.size() == times.size() + 3);
+  REQUIRE(timer.getResult("a", r, true));
+  REQUIRE(r.median == expected(all, 50.));
+  // new measurements are merged into the view
+  REQUIRE(timer.getPercentiles("a", percents, percentiles));
+  for (size_t i = 0; i < percents.size(); ++i) {
+    REQUIRE(percentiles[i] == expected(all, percents[i]));
+  }
+
+  // the measurements keep the order they were recorded in
+  REQUIRE(std::equal(times.begin(), times.end(), recorded().begin()));
+
+  // without a sorted view the median is selected without reordering as well
+  for (const size_t n : {size_t{4}, size_t{5}}) {
+    const std::vector<PreciseTime> first(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(n));
+    CollectingTimer fresh(first, "b");
+    REQUIRE(fresh.getResult("b", r, false));
+    REQUIRE(r.median == expected(first, 50.));
+  }
+
+  CollectingTimer streaming(CollectingTimer::Storage::STREAMING);
+  streaming.start("s");
+  streaming.stop("s");
+  REQUIRE_FALSE(streaming.getPercentiles("s", percents, percentiles));
+  REQUIRE_FALSE(timer.getPercentiles("unknown", percents, percentiles));
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_window_timer") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  std::vector<PreciseTime> times;
+  for (int i = 1; i <= 10; ++i) {
+    times.emplace_back(ms(i));
+  }
+  // the SAMPLES are folded into the window, only the last 4 are kept
+  CollectingTimer timer(times, "a");
+  const CollectingTimer::TimerId a = timer.registerTimer("a");
+  timer.setWindow(a, 4);
+  CollectingTimer::Result r;
+  REQUIRE(timer.getResult("a", r));
+  REQUIRE(r.number_measurements == 4);
+  REQUIRE(r.number_outliners == 0);
+  REQUIRE(r.mean == PreciseTime(us(8500)));
+  REQUIRE(r.median == PreciseTime(us(8500)));
+  REQUIRE(r.min_measurement == PreciseTime(ms(7)));
+  REQUIRE(r.max_measurement == PreciseTime(ms(10)));
+  const std::vector<PreciseTime> last(times.end() - 4, times.end());
+  REQUIRE(r.standard_derivation ==
+          PreciseTimeAccumulator::fromColumn(PreciseTimeColumn(last)).standardDeviation());
+  REQUIRE(r.quantile(1.) == PreciseTime(ms(10)));
+  int counted = 0;
+  for (const auto& bucket : r.h.buckets) {
+    counted += bucket.num;
+  }
+  REQUIRE(counted == 4);
+
+  // the window does not grow, the oldest measurements make room
+  for (int i = 0; i < 3; ++i) {
+    timer.start(a);
+    timer.stop(a);
+  }
+  REQUIRE(timer.getResult("a", r));
+  REQUIRE(r.number_measurements == 4);
+  REQUIRE(r.max_measurement == PreciseTime(ms(10)));
+  REQUIRE(r.min_measurement < PreciseTime(ms(1)));
+
+  // the running sums are exact after many evictions
+  std::mt19937_64 generator(29);  // NOLINT fixed seed for repeatable runs
+  std::normal_distribution<double> durations(1e6, 1e5);
+  std::vector<PreciseTime> many;
+  for (size_t i = 0; i < 10000; ++i) {
+    many.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+  }
+  CollectingTimer sliding(many, "b");
+  sliding.setWindow(sliding.registerTimer("b"), 1000);
+  REQUIRE(sliding.getResult("b", r));
+  const std::vector<PreciseTime> window(many.end() - 1000, many.end());
+  const auto acc = PreciseTimeAccumulator::fromColumn(PreciseTimeColumn(window));
+  REQUIRE(r.number_measurements == 1000);
+  REQUIRE(r.mean == acc.mean());
+  REQUIRE(r.standard_derivation == acc.standardDeviation());
+  REQUIRE(r.min_measurement == *std::min_element(window.begin(), window.end()));
+  REQUIRE(r.max_measurement == *std::max_element(window.begin(), window.end()));
+  // exact percentiles only for SAMPLES timers
+  REQUIRE(!sliding.getPercentiles("b", {50.}, times));
+
+  // measurements older than the max age are dropped
+  CollectingTimer aging;
+  const CollectingTimer::TimerId c = aging.registerTimer("c");
+  aging.setWindow(c, 100, ms(20));
+  for (int i = 0; i < 5; ++i) {
+    aging.start(c);
+    aging.stop(c);
+  }
+  REQUIRE(aging.getResult("c", r));
+  REQUIRE(r.number_measurements == 5);
+  std::this_thread::sleep_for(ms(40));
+  REQUIRE(!aging.getResult("c", r));
+  REQUIRE(r.number_measurements == 0);
+
+  // registered with the default capacity
+  CollectingTimer defaults;
+  const CollectingTimer::TimerId d = defaults.registerTimer("d", CollectingTimer::Storage::WINDOW);
+  for (size_t i = 0; i < CollectingTimer::DEFAULT_WINDOW_CAPACITY + 10; ++i) {
+    defaults.start(d);
+    defaults.stop(d);
+  }
+  REQUIRE(defaults.getResult("d", r));
+  REQUIRE(r.number_measurements == CollectingTimer::DEFAULT_WINDOW_CAPACITY);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_reservoir_timer") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  // 0, 1, 2, ... ns: the first and the last ones must not be preferred
+  constexpr int64_t N = 1000000;
+  PreciseTimeColumn column;
+  PreciseTimeAccumulator acc;
+  column.reserve(N);
+  for (int64_t i = 0; i < N; ++i) {
+    column.push_back(ns(i));
+    acc.add(i);
+  }
+  CollectingTimer timer(std::move(column), "a");
+  timer.setReservoir(timer.registerTimer("a"), 1000);
+  CollectingTimer::Result r;
+  REQUIRE(timer.getResult("a", r));
+  // exact
+  REQUIRE(r.number_measurements == N);
+  REQUIRE(r.mean == acc.mean());
+  REQUIRE(r.standard_derivation == acc.standardDeviation());
+  REQUIRE(r.min_measurement == PreciseTime(ns(0)));
+  REQUIRE(r.max_measurement == PreciseTime(ns(N - 1)));
+  // from the sample of 1000: the median is off by less than 3 of its
+  // standard deviations N / (2 sqrt(1000))
+  REQUIRE(r.is_outliner.size() == 1000);
+  REQUIRE(r.number_outliners == 0);
+  REQUIRE(r.median > PreciseTime(ns(N / 2 - 48000)));
+  REQUIRE(r.median < PreciseTime(ns(N / 2 + 48000)));
+  REQUIRE(r.quantile(0.9) > PreciseTime(ns(N * 9 / 10 - 30000)));
+  REQUIRE(r.quantile(0.9) < PreciseTime(ns(N * 9 / 10 + 30000)));
+  int binned = 0;
+  for (const auto& bucket : r.h.buckets) {
+    binned += bucket.num;
+  }
+  REQUIRE(binned == 1000);
+
+  // the histogram file is normed by the size of the sample
+  const std::string file_name = "test_reservoir_timer.csv";
+  std::remove(file_name.c_str());
+  timer.histogramToFile<ns>(file_name, ',');
+  std::ifstream file(file_name);
+  std::string line;
+  std::getline(file, line);
+  double normed_sum = 0;
+  while (std::getline(file, line)) {
+    normed_sum += std::stod(line.substr(line.find(',') + 1));
+  }
+  file.close();
+  std::remove(file_name.c_str());
+  REQUIRE(std::abs(normed_sum - 1.) < 1e-3);
+
+  // fewer measurements than the capacity are all kept
+  CollectingTimer few;
+  const CollectingTimer::TimerId b = few.registerTimer("b", CollectingTimer::Storage::RESERVOIR);
+  for (int i = 0; i < 11; ++i) {
+    few.start(b);
+    few.stop(b);
+  }
+  REQUIRE(few.getResult("b", r));
+  REQUIRE(r.number_measurements == 11);
+  REQUIRE(r.is_outliner.size() == 11);
+  REQUIRE(r.min_measurement <= r.median);
+  REQUIRE(r.median <= r.max_measurement);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_capture_file") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers) // these are random numbers I cant give every one a meaningfull name
+  std::mt19937_64 generator(31);  // NOLINT fixed seed for repeatable runs
+  std::lognormal_distribution<double> durations(12., 0.7);
+  std::vector<PreciseTime> times;
+  for (size_t i = 0; i < 100000; ++i) {
+    times.emplace_back(ns(static_cast<int64_t>(durations(generator))));
+  }
+  times[5] = ns(-3);  // negative values survive as well
+  CollectingTimer timer(times, "long name with spaces, commas and ü");
+  for (int i = 0; i < 7; ++i) {
+    timer.start("b");
+    timer.stop("b");
+  }
+  timer.registerTimer("streaming", CollectingTimer::Storage::STREAMING);
+  timer.start("streaming");
+  timer.stop("streaming");
+
+  const std::string file_name = "test_capture_file.bin";
+  std::remove(file_name.c_str());
+  REQUIRE(timer.measurementsToCapture(file_name));
+
+  CaptureFile capture;
+  REQUIRE(capture.open(file_name));
+  REQUIRE(capture.isOpen());
+  // only SAMPLES timers, sorted by name
+  REQUIRE(capture.numColumns() == 2);
+  REQUIRE(capture.column(0).name == "b");
+  REQUIRE(capture.column(1).name == "long name with spaces, commas and ü");
+  REQUIRE(capture.column(0).size == 7);
+  const CaptureFile::Column* column = capture.find("long name with spaces, commas and ü");
+  REQUIRE(column != nullptr);
+  REQUIRE(capture.find("streaming") == nullptr);
+  REQUIRE(column->size == times.size());
+  REQUIRE(std::equal(times.begin(), times.end(), column->data, [](const PreciseTime& t, int64_t nanos) {
+    return PreciseTimeColumn::toNanoseconds(t) == nanos;
+  }));
+
+  // the statistics directly from the mapped file match the ones of the timer
+  const std::string name(column->name);
+  CollectingTimer::Result expected;
+  REQUIRE(timer.getResult(name, expected, false));
+  for (const size_t num_threads : {size_t{1}, size_t{4}}) {
+    CollectingTimer::Result r;
+    REQUIRE(CollectingTimer::getResult(capture, name, r, num_threads));
+    REQUIRE(r.timer_name == name);
+    REQUIRE(r.number_measurements == expected.number_measurements);
+    REQUIRE(r.number_outliners == expected.number_outliners);
+    REQUIRE(r.mean == expected.mean);
+    REQUIRE(r.median == expected.median);
+    REQUIRE(r.standard_derivation == expected.standard_derivation);
+    REQUIRE(r.is_outliner == expected.is_outliner);
+    REQUIRE(r.h.buckets.size() == expected.h.buckets.size());
+  }
+  // the median from the sketch is exact for odd and even counts
+  for (const size_t n : {size_t{3}, size_t{4}, size_t{1001}, size_t{1002}}) {
+    const std::vector<PreciseTime> first(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(n));
+    CollectingTimer part(first, "p");
+    // a mapped file must not be rewritten
+    const std::string part_name = "test_capture_file_part.bin";
+    REQUIRE(part.measurementsToCapture(part_name));
+    CaptureFile part_capture;
+    REQUIRE(part_capture.open(part_name));
+    CollectingTimer::Result from_capture;
+    CollectingTimer::Result from_timer;
+    REQUIRE(CollectingTimer::getResult(part_capture, "p", from_capture));
+    REQUIRE(part.getResult("p", from_timer));
+    REQUIRE(from_capture.median == from_timer.median);
+    part_capture.close();
+    std::remove(part_name.c_str());
+  }
+
+  // a CollectingTimer copies the columns
+  CollectingTimer loaded(capture);
+  CollectingTimer::Result r;
+  REQUIRE(loaded.getResult(name, r, false));
+  REQUIRE(r.mean == expected.mean);
+  REQUIRE(r.median == expected.median);
+  REQUIRE(loaded.getResult("b", r));
+  REQUIRE(r.number_measurements == 7);
+
+  // moving keeps the mapping
+  CaptureFile moved(std::move(capture));
+  REQUIRE(moved.isOpen());
+  REQUIRE(!capture.isOpen());  // NOLINT checking the moved from state
+  REQUIRE(moved.find(name)->data[7] == PreciseTimeColumn::toNanoseconds(times[7]));
+  moved.close();
+
+  // files which are no captures or are cut off are rejected
+  {
+    std::ofstream text(file_name, std::ios_base::trunc);
+    text << "a,b\n1,2\n";
+  }
+  REQUIRE(!capture.open(file_name));
+  REQUIRE(timer.measurementsToCapture(file_name));
+  std::string content;
+  {
+    std::ifstream file(file_name, std::ios_base::binary);
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream cut(file_name, std::ios_base::binary | std::ios_base::trunc);
+    cut.write(content.data(), static_cast<std::streamsize>(content.size() / 2));
+  }
+  REQUIRE(!capture.open(file_name));
+  REQUIRE(!capture.open("does_not_exist.bin"));
+  std::remove(file_name.c_str());
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_exporter") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers)
+  const std::string file_name = "test_exporter.csv";
+  const auto measure = [](CollectingTimer& timer, CollectingTimer::TimerId id) {
+    timer.start(id);
+    timer.stop(id);
+  };
+  const auto readLines = [&file_name]() {
+    std::vector<std::string> lines;
+    std::ifstream file(file_name);
+    for (std::string line; std::getline(file, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  };
+
+  {
+    Exporter exporter(file_name, ';', std::chrono::hours(1));
+    REQUIRE(exporter.isOpen());
+
+    CollectingTimer timer;
+    const auto a = timer.registerTimer("a");
+    measure(timer, a);
+    measure(timer, a);
+    REQUIRE(exporter.push(timer));
+    // only new measurements are pushed
+    REQUIRE(!exporter.push(timer));
+    measure(timer, a);
+    REQUIRE(exporter.push(timer, false));
+    CollectingTimer::Result r;
+    REQUIRE(!timer.getResult("a", r));
+
+    FrameTimer frame_timer;
+    for (int frame = 0; frame < 2; ++frame) {
+      frame_timer.frameStart();
+      {
+        const auto scoped = frame_timer.startScopedTimer("f");
+      }
+    }
+    frame_timer.frameStop();
+    REQUIRE(exporter.push(frame_timer));
+    REQUIRE(!exporter.push(frame_timer));
+
+    // flush does not wait for the flush interval
+    exporter.flush();
+    const std::vector<std::string> lines = readLines();
+    REQUIRE(lines.size() == 1 + 3 + 2 * 2);
+    REQUIRE(lines[0] == "frame;timer;measurement ns");
+    REQUIRE(lines[1].rfind(";a;", 0) == 0);
+    REQUIRE(lines[3].rfind(";a;", 0) == 0);
+    REQUIRE(lines[4].rfind("0;Frame;", 0) == 0);
+    REQUIRE(lines[5].rfind("0;f;", 0) == 0);
+    REQUIRE(lines[7].rfind("1;f;", 0) == 0);
+    REQUIRE(exporter.getDropped() == 0);
+  }
+
+  // every measurement is either written or counted as dropped
+  {
+    size_t dropped = 0;
+    {
+      Exporter exporter(file_name, ',', std::chrono::hours(1), 1, Exporter::Backpressure::DROP);
+      CollectingTimer timer;
+      const auto b = timer.registerTimer("b");
+      for (int i = 0; i < 100; ++i) {
+        measure(timer, b);
+        exporter.push(timer, false);
+      }
+      exporter.flush();
+      dropped = exporter.getDropped();
+    }
+    REQUIRE(readLines().size() - 1 + dropped == 100);
+  }
+
+  // the destructor writes everything which is queued
+  {
+    Exporter exporter(file_name, ';', std::chrono::hours(1), 2);
+    CollectingTimer timer;
+    const auto c = timer.registerTimer("c");
+    for (int i = 0; i < 50; ++i) {
+      measure(timer, c);
+      REQUIRE(exporter.push(timer));
+    }
+  }
+  REQUIRE(readLines().size() == 51);
+  REQUIRE(readLines().back().rfind(";c;", 0) == 0);
+
+  REQUIRE(!Exporter("does/not/exist/test_exporter.csv").isOpen());
+  std::remove(file_name.c_str());
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_overhead_calibration") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers)
+  {
+    CollectingTimer timer;
+    CollectingTimer::Result distribution;
+    const PreciseTime overhead = timer.calibrateOverhead(distribution, 1000);
+    REQUIRE(overhead >= PreciseTime::zero());
+    REQUIRE(overhead == timer.getOverhead());
+    REQUIRE(overhead == distribution.median);
+    REQUIRE(distribution.number_measurements == 1000);
+  }
+  {
+    BasicCollectingTimer<TscClock> timer;
+    const PreciseTime overhead = timer.calibrateOverhead(100);
+    REQUIRE(overhead == timer.getOverhead());
+  }
+
+  std::vector<PreciseTime> times;
+  for (int i = 0; i < 1000; ++i) {
+    times.emplace_back(ns(100 + i % 50));
+  }
+  CollectingTimer timer(times, "a");
+  CollectingTimer::Result raw;
+  REQUIRE(timer.getResult("a", raw));
+  REQUIRE(raw.overhead == PreciseTime::zero());
+  REQUIRE(raw.corrected().mean == raw.mean);
+
+  timer.setOverhead(ns(120));
+  REQUIRE(timer.getResult("a", raw));
+  REQUIRE(raw.overhead == PreciseTime(ns(120)));
+  REQUIRE(raw.subtracted == PreciseTime::zero());
+  REQUIRE(raw.min_measurement == PreciseTime(ns(100)));
+
+  const CollectingTimer::Result corrected = raw.corrected();
+  REQUIRE(corrected.subtracted == PreciseTime(ns(120)));
+  REQUIRE(corrected.mean == raw.mean - PreciseTime(ns(120)));
+  REQUIRE(corrected.median == raw.median - PreciseTime(ns(120)));
+  REQUIRE(corrected.max_measurement == PreciseTime(ns(29)));
+  // never below 0
+  REQUIRE(corrected.min_measurement == PreciseTime::zero());
+  REQUIRE(corrected.standard_derivation == raw.standard_derivation);
+  REQUIRE(corrected.quantile(1.) == PreciseTime(ns(29)));
+  REQUIRE(corrected.quantiles({0., 1.})[1] == PreciseTime(ns(29)));
+  REQUIRE(corrected.h.buckets.back().end == raw.h.buckets.back().end - PreciseTime(ns(120)));
+  // correcting twice subtracts once
+  REQUIRE(corrected.corrected().mean == corrected.mean);
+  std::stringstream printed;
+  printed << corrected;
+  REQUIRE(printed.str().find("Overhead:") != std::string::npos);
+
+  ConcurrentCollectingTimer concurrent;
+  const auto id               = concurrent.registerTimer("c");
+  const PreciseTime overhead  = concurrent.calibrateOverhead(1000);
+  concurrent.attachThread();
+  for (int i = 0; i < 10; ++i) {
+    concurrent.start(id);
+    concurrent.stop(id);
+  }
+  CollectingTimer::Result r;
+  REQUIRE(concurrent.getResult("c", r));
+  REQUIRE(r.overhead == overhead);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_call_tree_timer") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers)
+  CallTreeTimer tree;
+  volatile int sink = 0;
+  const auto work = [&sink](int n) {
+    for (int i = 0; i < n; ++i) {
+      sink = sink + i;
+    }
+  };
+  for (int frame = 0; frame < 10; ++frame) {
+    const auto outer = tree.startScopedTimer("outerLoop");
+    work(1000);
+    for (int i = 0; i < 3; ++i) {
+      const auto inner = tree.startScopedTimer("innerLoop");
+      REQUIRE(tree.getDepth() == 2);
+      work(100);
+    }
+    tree.start("leaf");
+    tree.stop();
+  }
+  // the same name called from the root is another node
+  tree.start("innerLoop");
+  tree.stop();
+  tree.stop();  // nothing is running, ignored
+  REQUIRE(tree.getDepth() == 0);
+
+  const auto& nodes = tree.getNodes();
+  REQUIRE(nodes.size() == 5);
+  const auto outer = tree.find("outerLoop");
+  const auto inner = tree.find("outerLoop/innerLoop");
+  const auto leaf  = tree.find("outerLoop/leaf");
+  REQUIRE(outer != CallTreeTimer::ROOT);
+  REQUIRE(inner != CallTreeTimer::ROOT);
+  REQUIRE(leaf != CallTreeTimer::ROOT);
+  REQUIRE(tree.find("innerLoop") != inner);
+  REQUIRE(tree.find("does/not/exist") == CallTreeTimer::ROOT);
+  REQUIRE(nodes[inner].parent == outer);
+  REQUIRE(nodes[inner].depth == 2);
+  REQUIRE(nodes[outer].calls == 10);
+  REQUIRE(nodes[inner].calls == 30);
+
+  // the self time of a node is its inclusive time without the children
+  REQUIRE(nodes[outer].self_ticks ==
+          nodes[outer].inclusive_ticks - nodes[inner].inclusive_ticks - nodes[leaf].inclusive_ticks);
+  REQUIRE(nodes[inner].self_ticks == nodes[inner].inclusive_ticks);
+  REQUIRE(nodes[outer].self_ticks >= 0);
+
+  const auto results = tree.getResults();
+  REQUIRE(results.size() == 4);
+  // depth first, the children in the order they were first called
+  REQUIRE(results[0].id == outer);
+  REQUIRE(results[1].id == inner);
+  REQUIRE(results[2].id == leaf);
+  REQUIRE(results[3].name == "innerLoop");
+  REQUIRE(results[0].calls == 10);
+  REQUIRE(results[0].inclusive.timer_name == "outerLoop");
+  REQUIRE(results[0].inclusive.number_measurements == 10);
+  REQUIRE(results[0].self.number_measurements == 10);
+  REQUIRE(results[0].inclusive_total >= results[0].self_total);
+  REQUIRE(results[0].inclusive.mean >= results[0].self.mean);
+  REQUIRE(results[1].inclusive.timer_name == "outerLoop/innerLoop");
+  REQUIRE(results[1].inclusive.mean == results[1].self.mean);
+
+  CallTreeTimer::NodeResult r;
+  REQUIRE(tree.getResult(outer, r));
+  REQUIRE(!tree.getResult(tree.find("innerLoop"), r));  // only 1 measurement
+  REQUIRE(r.calls == 1);
+  REQUIRE(!tree.getResult(CallTreeTimer::ROOT, r));
+
+  std::stringstream printed;
+  printed << tree;
+  // the children are indented
+  REQUIRE(printed.str().find(" outerLoop\n") != std::string::npos);
+  REQUIRE(printed.str().find("   innerLoop\n") != std::string::npos);
+
+  const std::string file_name = "test_call_tree_timer.csv";
+  std::remove(file_name.c_str());
+  REQUIRE(tree.treeToFile<std::chrono::microseconds>(file_name, ';'));
+  std::ifstream file(file_name);
+  std::string line;
+  size_t num_lines = 0;
+  while (std::getline(file, line)) {
+    ++num_lines;
+  }
+  REQUIRE(num_lines == 5);
+  file.close();
+  std::remove(file_name.c_str());
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_call_tree_timer_seperator_in_name") {
+  // NOLINTBEGIN(readability-magic-numbers)
+  CallTreeTimer tree;
+  // "a/b" at the root and "b" below "a" would share the path "a/b"
+  tree.start("a/b");
+  tree.stop();
+  tree.start("a");
+  tree.start("b");
+  tree.stop();
+  tree.stop();
+  tree.start("c");
+  tree.stop();
+
+  const auto& nodes = tree.getNodes();
+  REQUIRE(nodes.size() == 5);
+  const auto slash = tree.find("a\\/b");
+  const auto b     = tree.find("a/b");
+  const auto c     = tree.find("c");
+  REQUIRE(slash != CallTreeTimer::ROOT);
+  REQUIRE(b != CallTreeTimer::ROOT);
+  REQUIRE(slash != b);
+  REQUIRE(nodes[slash].name == "a/b");
+  REQUIRE(nodes[b].name == "b");
+  REQUIRE(c != CallTreeTimer::ROOT);
+
+  // every node has its own timers
+  REQUIRE(nodes[slash].inclusive_timer != nodes[b].inclusive_timer);
+  REQUIRE(nodes[c].inclusive_timer != nodes[b].inclusive_timer);
+  REQUIRE(nodes[c].self_timer != nodes[slash].self_timer);
+  for (size_t id = 1; id < nodes.size(); ++id) {
+    REQUIRE(nodes[id].calls == 1);
+  }
+  const auto results = tree.getResults();
+  REQUIRE(results.size() == 4);
+  for (const auto& result : results) {
+    REQUIRE(result.calls == 1);
+  }
+  // NOLINTEND(readability-magic-numbers)
+}
+
+TEST_CASE("test_compressed_column") {  // NOLINT readability-function-cognitive-complexity // Happens inn big tests
+  // NOLINTBEGIN(readability-magic-numbers)
+  std::mt19937_64 gen(7);
+  std::normal_distribution<double> jitter(1000., 100.);
+  std::vector<int64_t> values;
+  for (size_t i = 0; i < 100000; ++i) {
+    values.push_back(static_cast<int64_t>(jitter(gen)));
+  }
+  // extremes and constant runs round trip too
+  values.push_back(std::numeric_limits<int64_t>::max());
+  values.push_back(std::numeric_limits<int64_t>::min());
+  values.push_back(-5);
+  values.insert(values.end(), 300, 42);
+
+  CompressedColumn column;
+  for (const int64_t value : values) {
+    column.push_back(value);
+  }
+  REQUIRE(column.size() == values.size());
+  REQUIRE(column.numBlocks() == (values.size() + CompressedColumn::BLOCK_SIZE - 1) / CompressedColumn::BLOCK_SIZE);
+  std::array<int64_t, CompressedColumn::BUFFER_SIZE> buffer{};
+  size_t i = 0;
+  for (size_t b = 0; b < column.numBlocks(); ++b) {
+    const int64_t* block = column.block(b, buffer.data());
+    for (size_t j = 0; j < column.blockSize(b); ++j, ++i) {
+      REQUIRE(block[j] == values[i]);
+    }
+  }
+  REQUIRE(i == values.size());
+  REQUIRE(column.at(100001) == std::numeric_limits<int64_t>::min());
+  // neighbours within a few hundred ns take less than 2 of 8 bytes
+  REQUIRE(column.packedBytes() < values.size() * 2);
+  column.clear();
+  REQUIRE(column.empty());
+
+  // a COMPRESSED timer reports exactly what a SAMPLES timer does
+  std::vector<PreciseTime> times;
+  std::gamma_distribution<double> gamma(2., 300.);
+  for (size_t n = 0; n < 600000; ++n) {
+    times.emplace_back(std::chrono::nanoseconds(500 + static_cast<int64_t>(gamma(gen))));
+  }
+  CollectingTimer samples(times, "a");
+  CollectingTimer compressed(times, "a");
+  compressed.setStorage(compressed.registerTimer("a"), CollectingTimer::Storage::COMPRESSED);
+  for (const size_t threads : {size_t{1}, size_t{3}}) {
+    samples.setReportThreads(threads);
+    compressed.setReportThreads(threads);
+    CollectingTimer::Result expected;
+    CollectingTimer::Result r;
+    REQUIRE(samples.getResult("a", expected, false));
+    REQUIRE(compressed.getResult("a", r));
+    REQUIRE(r.number_measurements == expected.number_measurements);
+    REQUIRE(r.mean == expected.mean);
+    REQUIRE(r.median == expected.median);
+    REQUIRE(r.standard_derivation == expected.standard_derivation);
+    REQUIRE(r.min_measurement == expected.min_measurement);
+    REQUIRE(r.max_measurement == expected.max_measurement);
+    REQUIRE(r.number_outliners == expected.number_outliners);
+    REQUIRE(r.is_outliner == expected.is_outliner);
+    REQUIRE(r.h.buckets.size() == expected.h.buckets.size());
+    REQUIRE(r.h.max_num_in_bucket == expected.h.max_num_in_bucket);
+    REQUIRE(r.quantile(0.99) == expected.quantile(0.99));
+  }
+
+  // recorded measurements are packed on stop
+  CollectingTimer timer(CollectingTimer::Storage::COMPRESSED);
+  const auto id = timer.registerTimer("c");
+  for (int n = 0; n < 1000; ++n) {
+    timer.start(id);
+    timer.stop(id);
+  }
+  CollectingTimer::Result r;
+  REQUIRE(timer.getResult("c", r));
+  REQUIRE(r.number_measurements == 1000);
+  REQUIRE(r.min_measurement <= r.median);
+  REQUIRE(r.median <= r.max_measurement);
+  // NOLINTEND(readability-magic-numbers)
+}
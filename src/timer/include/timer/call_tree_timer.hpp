@@ -0,0 +1,387 @@
+/**
+ * @file call_tree_timer.hpp
+ * @brief Implements a timer which records nested timers as a call tree: a
+ * timer started while another one runs becomes its child, so the time of a
+ * node is reported inclusive its children and as self time without them.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef CALL_TREE_TIMER_H
+#define CALL_TREE_TIMER_H
+
+#include "clock.hpp"
+#include "collecting_timer.hpp"
+#include "precise_time.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * @brief Records nested timers into a call tree.
+ *
+ * start(name) looks the name up among the children of the running node (or
+ * creates it) and pushes it on the scope stack, stop() pops it. So the same
+ * name called from two places are two nodes, e.g. "outerLoop/innerLoop" and
+ * "innerLoop". The nodes live in one vector and are referenced by NodeId.
+ *
+ * Every measurement is kept twice in a CollectingTimer named by the path of
+ * the node: inclusive (start to stop) and self (without the time of the
+ * children measured in between), so all statistics, files and histograms of
+ * the CollectingTimer are available for both. The sums per node are kept
+ * exact in clock ticks.
+ *
+ * The scope stack belongs to the instance: use one instance per thread.
+ * @tparam Clock The clock policy, see clock.hpp.
+ */
+template <class Clock = DefaultClock>
+class BasicCallTreeTimer {
+ public:
+  using time_point = typename Clock::time_point;
+  using Collected  = BasicCollectingTimer<Clock>;
+  using Result     = typename Collected::Result;
+
+  /// Index of a node in the tree, see getNodes().
+  using NodeId = size_t;
+
+  /// The root of the tree, it is no timer. Also marks "no node" in the links.
+  static constexpr NodeId ROOT = 0;
+
+  /// Seperates the names in the path of a node.
+  static constexpr char PATH_SEPERATOR = '/';
+
+  /// Escapes PATH_SEPERATOR (and itself) inside a name in the path of a node.
+  static constexpr char PATH_ESCAPE = '\\';
+
+  /*!
+   * @brief A node of the call tree: a name within its parent.
+   */
+  struct Node {
+    std::string name;
+    /// The names from the root to this node, seperated by PATH_SEPERATOR.
+    /// A PATH_SEPERATOR or PATH_ESCAPE inside a name is preceded by PATH_ESCAPE.
+    std::string path;
+    /// The timers of this node in getInclusive() and getSelf().
+    typename Collected::TimerId inclusive_timer = 0;
+    typename Collected::TimerId self_timer      = 0;
+    NodeId parent           = ROOT;
+    NodeId first_child      = ROOT;
+    NodeId next_sibling     = ROOT;
+    size_t depth            = 0;
+    size_t calls            = 0;
+    int64_t inclusive_ticks = 0;
+    int64_t self_ticks      = 0;
+  };
+
+  /*!
+   * @brief The statistics of one node.
+   */
+  struct NodeResult {
+    NodeId id     = ROOT;
+    NodeId parent = ROOT;
+    size_t depth  = 0;
+    std::string name;
+    size_t calls = 0;
+    /// The exact sum of all measurements inclusive the children.
+    PreciseTime inclusive_total;
+    /// The exact sum of all measurements without the children.
+    PreciseTime self_total;
+    /// The statistics of the single measurements, named by the path.
+    Result inclusive;
+    Result self;
+  };
+
+  /*!
+   * @brief Starts a timer on construction, stops it on destruction, see
+   * startScopedTimer().
+   */
+  class Scope {
+   public:
+    Scope(BasicCallTreeTimer& call_tree, std::string_view name) : tree(call_tree) { tree.start(name); }
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() { tree.stop(); }
+
+   private:
+    BasicCallTreeTimer& tree;
+  };
+
+  /// The depth of the scope stack which is reserved up front.
+  static constexpr size_t RESERVED_DEPTH = 64;
+
+  BasicCallTreeTimer() {
+    nodes.emplace_back();
+    stack.reserve(RESERVED_DEPTH);
+  }
+
+  /*!
+   * @brief Starts a timer as child of the running one (or of the root).
+   * Nodes are only allocated the first time a name is called from a node.
+   * @param name The name of the timer.
+   * @return The node of the timer.
+   */
+  NodeId start(std::string_view name) {
+    const NodeId parent = stack.empty() ? ROOT : stack.back().node;
+    const NodeId node   = child(parent, name);
+    stack.push_back(Frame{node, time_point{}, 0});
+    stack.back().start = Clock::start();
+    return node;
+  }
+
+  /*!
+   * @brief Stops the timer started last, saves its inclusive and its self
+   * time and adds the inclusive time to the children time of its parent.
+   */
+  void stop() noexcept {
+    const time_point stop = Clock::stop();
+    if (stack.empty()) {
+      // TODO debugMsg: No timer was started
+      return;
+    }
+    const Frame frame = stack.back();
+    stack.pop_back();
+    const int64_t ticks      = Clock::elapsedTicks(frame.start, stop);
+    const int64_t self_ticks = ticks - frame.children_ticks;
+    Node& node               = nodes[frame.node];
+    ++node.calls;
+    node.inclusive_ticks += ticks;
+    node.self_ticks      += self_ticks;
+    inclusive.timers[node.inclusive_timer].add(ticks, stop);
+    self.timers[node.self_timer].add(self_ticks, stop);
+    if (!stack.empty()) {
+      stack.back().children_ticks += ticks;
+    }
+  }
+
+  /*!
+   * @brief Starts a timer which stops when the returned Scope is destroyed.
+   */
+  [[nodiscard]] Scope startScopedTimer(std::string_view name) { return Scope(*this, name); }
+
+  /// All nodes, index 0 is the root. The ids stay valid.
+  const std::vector<Node>& getNodes() const noexcept { return nodes; }
+
+  /// The number of timers which are running.
+  size_t getDepth() const noexcept { return stack.size(); }
+
+  /*!
+   * @brief Returns the node with the given path, e.g. "outerLoop/innerLoop",
+   * ROOT if there is none. A name containing PATH_SEPERATOR must be escaped,
+   * see Node::path.
+   */
+  NodeId find(std::string_view path) const noexcept {
+    for (NodeId id = 1; id < nodes.size(); ++id) {
+      if (nodes[id].path == path) {
+        return id;
+      }
+    }
+    return ROOT;
+  }
+
+  /*!
+   * @brief Calculates the statistics of one node, see
+   * BasicCollectingTimer::getResult().
+   * @return false if there is no such node or it has less than 3
+   * measurements, the totals are filled in anyway.
+   */
+  bool getResult(NodeId id, NodeResult& result, bool sort_measurements = true) noexcept {
+    if (id == ROOT || id >= nodes.size()) {
+      return false;
+    }
+    const Node& node       = nodes[id];
+    result.id              = id;
+    result.parent          = node.parent;
+    result.depth           = node.depth;
+    result.name            = node.name;
+    result.calls           = node.calls;
+    result.inclusive_total = Clock::toPreciseTime(node.inclusive_ticks);
+    result.self_total      = Clock::toPreciseTime(node.self_ticks);
+    const bool has_inclusive = inclusive.getResult(node.path, result.inclusive, sort_measurements);
+    const bool has_self      = self.getResult(node.path, result.self, sort_measurements);
+    return has_inclusive && has_self;
+  }
+
+  /*!
+   * @brief Calculates the statistics of all nodes.
+   * @return The nodes in depth first order, every node before its children
+   * and the children in the order they were first called.
+   */
+  std::vector<NodeResult> getResults(bool sort_measurements = true) {
+    std::vector<NodeResult> results;
+    results.reserve(nodes.size() - 1);
+    forEachDepthFirst([&](NodeId id) {
+      results.emplace_back();
+      getResult(id, results.back(), sort_measurements);
+    });
+    return results;
+  }
+
+  /// The measurements inclusive the children, named by the path of the node.
+  Collected& getInclusive() noexcept { return inclusive; }
+
+  /// The measurements without the children, named by the path of the node.
+  Collected& getSelf() noexcept { return self; }
+
+  /*!
+   * @brief Writes one line per node (appends) with its totals and means for
+   * further analysis with Excel or Matlab.
+   * @tparam T a std::chrono duration in which the time (as double values)
+   * should be printed.
+   * @param file_name The name of the file to write into. If its a path, the
+   * path must exist.
+   * @param seperator A character to seperate the input fields.
+   * @return true if writing was successfull.
+   */
+  template <class T>
+  bool treeToFile(const std::string& file_name, char seperator) {
+    std::ofstream file;
+    file.open(file_name.c_str(), std::ios_base::app);
+    if (!file.is_open()) {
+      return false;
+    }
+    const std::string unit = timeunit2String<T>();
+    file << "node" << seperator << "parent" << seperator << "depth" << seperator << "path" << seperator
+         << "calls" << seperator << "inclusive " << unit << seperator << "self " << unit << seperator
+         << "inclusive mean " << unit << seperator << "self mean " << unit << "\n";
+    forEachDepthFirst([&](NodeId id) {
+      const Node& node             = nodes[id];
+      const PreciseTime in_total   = Clock::toPreciseTime(node.inclusive_ticks);
+      const PreciseTime self_total = Clock::toPreciseTime(node.self_ticks);
+      const double calls           = static_cast<double>(node.calls);
+      file << id << seperator << node.parent << seperator << node.depth << seperator << node.path
+           << seperator << node.calls << seperator << std::to_string(in_total.toDouble<T>()) << seperator
+           << std::to_string(self_total.toDouble<T>()) << seperator
+           << std::to_string(in_total.toDouble<T>() / calls) << seperator
+           << std::to_string(self_total.toDouble<T>() / calls) << "\n";
+    });
+    return !file.bad();
+  }
+
+  /*!
+   * @brief Prints the call tree: per node the inclusive and the self time
+   * in total and in % of all top level timers, and the number of calls.
+   */
+  friend std::ostream& operator<<(std::ostream& os, const BasicCallTreeTimer& t) {
+    int64_t total_ticks = 0;
+    for (NodeId id = t.nodes[ROOT].first_child; id != ROOT; id = t.nodes[id].next_sibling) {
+      total_ticks += t.nodes[id].inclusive_ticks;
+    }
+    const double percent = total_ticks > 0 ? 100. / static_cast<double>(total_ticks) : 0.;
+    const std::ios_base::fmtflags flags = os.flags();
+    const std::streamsize precision     = os.precision();
+    os << "inclusive         self              calls     timer\n";
+    t.forEachDepthFirst([&](NodeId id) {
+      const Node& node = t.nodes[id];
+      const auto column = [&os](const PreciseTime& time, double share) {
+        std::array<char, PreciseTime::MAX_CHARS + 1> buffer{};
+        *time.timeStringToChars(buffer.data(), buffer.data() + PreciseTime::MAX_CHARS, 3).ptr = '\0';
+        os << std::left << std::setw(10) << buffer.data() << std::right << std::setw(5)
+           << std::fixed << std::setprecision(1) << share << "%  ";
+      };
+      column(Clock::toPreciseTime(node.inclusive_ticks), static_cast<double>(node.inclusive_ticks) * percent);
+      column(Clock::toPreciseTime(node.self_ticks), static_cast<double>(node.self_ticks) * percent);
+      os << std::left << std::setw(10) << node.calls << std::string(2 * (node.depth - 1), ' ') << node.name
+         << "\n";
+    });
+    os.flags(flags);
+    os.precision(precision);
+    return os;
+  }
+
+ private:
+  /*!
+   * @brief A running timer on the scope stack.
+   */
+  struct Frame {
+    NodeId node = ROOT;
+    time_point start{};
+    /// The inclusive time of the children stopped so far, in clock ticks.
+    int64_t children_ticks = 0;
+  };
+
+  /*!
+   * @brief Appends name to path, escaping PATH_SEPERATOR and PATH_ESCAPE so
+   * that two different nodes never share a path (and so a timer).
+   */
+  static void appendEscaped(std::string& path, std::string_view name) {
+    path.reserve(path.size() + name.size());
+    for (const char c : name) {
+      if (c == PATH_SEPERATOR || c == PATH_ESCAPE) {
+        path += PATH_ESCAPE;
+      }
+      path += c;
+    }
+  }
+
+  /*!
+   * @brief Returns the child of parent with the given name, appends it as
+   * last child if there is none.
+   */
+  NodeId child(NodeId parent, std::string_view name) {
+    NodeId last = ROOT;
+    for (NodeId id = nodes[parent].first_child; id != ROOT; id = nodes[id].next_sibling) {
+      if (nodes[id].name == name) {
+        return id;
+      }
+      last = id;
+    }
+    const NodeId id = nodes.size();
+    Node node;
+    node.name   = std::string(name);
+    if (parent != ROOT) {
+      node.path = nodes[parent].path + PATH_SEPERATOR;
+    }
+    appendEscaped(node.path, name);
+    node.parent          = parent;
+    node.depth           = nodes[parent].depth + 1;
+    node.inclusive_timer = inclusive.registerTimer(node.path);
+    node.self_timer      = self.registerTimer(node.path);
+    nodes.push_back(std::move(node));
+    if (last == ROOT) {
+      nodes[parent].first_child = id;
+    } else {
+      nodes[last].next_sibling = id;
+    }
+    return id;
+  }
+
+  /*!
+   * @brief Calls visit(id) for every node but the root, every node before
+   * its children.
+   */
+  template <class Visit>
+  void forEachDepthFirst(const Visit& visit) const {
+    std::vector<NodeId> pending;
+    for (NodeId id = nodes[ROOT].first_child; id != ROOT; id = nodes[id].next_sibling) {
+      pending.push_back(id);
+    }
+    std::reverse(pending.begin(), pending.end());
+    while (!pending.empty()) {
+      const NodeId id = pending.back();
+      pending.pop_back();
+      visit(id);
+      const size_t first = pending.size();
+      for (NodeId c = nodes[id].first_child; c != ROOT; c = nodes[c].next_sibling) {
+        pending.push_back(c);
+      }
+      std::reverse(pending.begin() + static_cast<std::ptrdiff_t>(first), pending.end());
+    }
+  }
+
+  std::vector<Node> nodes;
+  std::vector<Frame> stack;
+  Collected inclusive;
+  Collected self;
+};
+
+using CallTreeTimer = BasicCallTreeTimer<>;
+
+#endif
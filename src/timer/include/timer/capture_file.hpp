@@ -0,0 +1,281 @@
+/**
+ * @file capture_file.hpp
+ * @brief Implements CaptureFile: a versioned binary columnar file of
+ * nanosecond measurements, written in one go and read by mapping the file
+ * into memory, so even captures of several GB are opened without reading or
+ * parsing them.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef CAPTURE_FILE_H
+#define CAPTURE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if !defined(CAPTURE_FILE_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define CAPTURE_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief A capture: named columns of int64_t nanoseconds.
+ *
+ * Layout of version 1, all fields in the byte order of the writer, which is
+ * recorded and checked by the reader:
+ * - FileHeader: magic, byte order mark, version, number of columns.
+ * - One ColumnHeader per column: offset and size of its name and its data,
+ *   the unit of the data as a fraction of a second (1/10^9).
+ * - The names.
+ * - The data of each column, raw int64_t, aligned to 8 bytes.
+ *
+ * open() maps the file read only (POSIX mmap, else it is read into memory
+ * once), the columns point directly into the mapped pages and are valid
+ * until the CaptureFile is closed or destroyed. The file must not be
+ * rewritten while it is mapped. Define CAPTURE_FILE_NO_MMAP to always read
+ * the file.
+ */
+class CaptureFile {
+ public:
+  static constexpr uint32_t VERSION = 1;
+
+  /// The unit of the samples: UNIT_NUMERATOR / UNIT_DENOMINATOR seconds.
+  static constexpr int64_t UNIT_NUMERATOR   = 1;
+  static constexpr int64_t UNIT_DENOMINATOR = 1000000000;
+
+  /**
+   * @brief A column of the capture: its name and its samples in
+   * nanoseconds.
+   */
+  struct Column {
+    std::string_view name;
+    const int64_t* data = nullptr;
+    size_t size         = 0;
+  };
+
+  CaptureFile() = default;
+  CaptureFile(const CaptureFile&)            = delete;
+  CaptureFile& operator=(const CaptureFile&) = delete;
+  CaptureFile(CaptureFile&& other) noexcept { *this = std::move(other); }
+  CaptureFile& operator=(CaptureFile&& other) noexcept {
+    if (this != &other) {
+      close();
+      std::swap(mapped, other.mapped);
+      std::swap(mapped_size, other.mapped_size);
+      std::swap(buffer, other.buffer);
+      std::swap(columns, other.columns);
+    }
+    return *this;
+  }
+  ~CaptureFile() { close(); }
+
+  /**
+   * @brief Writes the columns into the file (overwrites it).
+   * @param file_name The name of the file. If its a path, the path must exist.
+   * @param columns The columns to write.
+   * @return true if writing was successfull.
+   */
+  static bool write(const std::string& file_name, const std::vector<Column>& columns) {
+    std::ofstream file(file_name.c_str(), std::ios_base::binary | std::ios_base::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    FileHeader header;
+    header.num_columns = columns.size();
+    std::vector<ColumnHeader> column_headers(columns.size());
+    uint64_t offset = sizeof(FileHeader) + columns.size() * sizeof(ColumnHeader);
+    for (size_t c = 0; c < columns.size(); ++c) {
+      column_headers[c].name_offset = offset;
+      column_headers[c].name_size   = columns[c].name.size();
+      offset                       += columns[c].name.size();
+    }
+    offset = alignUp(offset);
+    const uint64_t names_end = offset;
+    for (size_t c = 0; c < columns.size(); ++c) {
+      column_headers[c].data_offset = offset;
+      column_headers[c].size        = columns[c].size;
+      offset                       += columns[c].size * sizeof(int64_t);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(column_headers.data()),
+               static_cast<std::streamsize>(column_headers.size() * sizeof(ColumnHeader)));
+    uint64_t written = sizeof(FileHeader) + columns.size() * sizeof(ColumnHeader);
+    for (const Column& column : columns) {
+      file.write(column.name.data(), static_cast<std::streamsize>(column.name.size()));
+      written += column.name.size();
+    }
+    const char padding[sizeof(int64_t)] = {};
+    file.write(padding, static_cast<std::streamsize>(names_end - written));
+    for (const Column& column : columns) {
+      file.write(reinterpret_cast<const char*>(column.data),
+                 static_cast<std::streamsize>(column.size * sizeof(int64_t)));
+    }
+    return file.good();
+  }
+
+  /**
+   * @brief Maps the file and checks its header, closes the file opened
+   * before.
+   * @param file_name The name of the file.
+   * @return false if the file can not be read or is no capture of this
+   * version and byte order.
+   */
+  bool open(const std::string& file_name) {
+    close();
+    if (!map(file_name) || !parse()) {
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  void close() noexcept {
+#ifdef CAPTURE_FILE_MMAP
+    if (mapped != nullptr && buffer.empty()) {
+      munmap(const_cast<char*>(mapped), mapped_size);
+    }
+#endif
+    mapped      = nullptr;
+    mapped_size = 0;
+    buffer      = std::vector<int64_t>();
+    columns.clear();
+  }
+
+  bool isOpen() const noexcept { return mapped != nullptr; }
+  size_t numColumns() const noexcept { return columns.size(); }
+  const Column& column(size_t i) const noexcept { return columns[i]; }
+  const std::vector<Column>& getColumns() const noexcept { return columns; }
+
+  /**
+   * @brief Returns the column with the given name, nullptr if there is
+   * none.
+   */
+  const Column* find(std::string_view name) const noexcept {
+    for (const Column& column : columns) {
+      if (column.name == name) {
+        return &column;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  static constexpr char MAGIC[8]            = {'T', 'I', 'M', 'E', 'R', 'C', 'A', 'P'};
+  static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  struct FileHeader {
+    char magic[8]        = {'T', 'I', 'M', 'E', 'R', 'C', 'A', 'P'};
+    uint32_t byte_order  = BYTE_ORDER_MARK;
+    uint32_t version     = VERSION;
+    uint64_t num_columns = 0;
+  };
+
+  struct ColumnHeader {
+    uint64_t name_offset     = 0;
+    uint64_t name_size       = 0;
+    uint64_t data_offset     = 0;
+    uint64_t size            = 0;
+    int64_t unit_numerator   = UNIT_NUMERATOR;
+    int64_t unit_denominator = UNIT_DENOMINATOR;
+  };
+
+  static uint64_t alignUp(uint64_t offset) noexcept {
+    return (offset + sizeof(int64_t) - 1) / sizeof(int64_t) * sizeof(int64_t);
+  }
+
+  bool map(const std::string& file_name) {
+#ifdef CAPTURE_FILE_MMAP
+    const int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat status {};
+    if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+      ::close(fd);
+      return false;
+    }
+    mapped_size = static_cast<size_t>(status.st_size);
+    void* address = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+      mapped_size = 0;
+      return false;
+    }
+    mapped = static_cast<const char*>(address);
+    return true;
+#else
+    std::ifstream file(file_name.c_str(), std::ios_base::binary | std::ios_base::ate);
+    if (!file.is_open()) {
+      return false;
+    }
+    mapped_size = static_cast<size_t>(file.tellg());
+    if (mapped_size == 0) {
+      return false;
+    }
+    // int64_t elements keep the data aligned
+    buffer.resize((mapped_size + sizeof(int64_t) - 1) / sizeof(int64_t));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(mapped_size))) {
+      return false;
+    }
+    mapped = reinterpret_cast<const char*>(buffer.data());
+    return true;
+#endif
+  }
+
+  /// true if the value of the file fits into a size_t, not given on 32 bit.
+  static bool fitsSize(uint64_t value) noexcept { return value <= std::numeric_limits<size_t>::max(); }
+
+  bool parse() {
+    FileHeader header;
+    if (mapped_size < sizeof(FileHeader)) {
+      return false;
+    }
+    std::memcpy(&header, mapped, sizeof(FileHeader));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.byte_order != BYTE_ORDER_MARK ||
+        header.version != VERSION || !fitsSize(header.num_columns) ||
+        header.num_columns > (mapped_size - sizeof(FileHeader)) / sizeof(ColumnHeader)) {
+      return false;
+    }
+    columns.resize(static_cast<size_t>(header.num_columns));
+    for (size_t c = 0; c < columns.size(); ++c) {
+      ColumnHeader column;
+      std::memcpy(&column, mapped + sizeof(FileHeader) + c * sizeof(ColumnHeader), sizeof(ColumnHeader));
+      const bool valid =
+        fitsSize(column.name_offset) && fitsSize(column.name_size) && fitsSize(column.data_offset) &&
+        fitsSize(column.size) && column.unit_numerator == UNIT_NUMERATOR && column.unit_denominator == UNIT_DENOMINATOR &&
+        column.name_offset <= mapped_size && column.name_size <= mapped_size - column.name_offset &&
+        column.data_offset % sizeof(int64_t) == 0 && column.data_offset <= mapped_size &&
+        column.size <= (mapped_size - column.data_offset) / sizeof(int64_t);
+      if (!valid) {
+        return false;
+      }
+      columns[c].name = std::string_view(mapped + static_cast<size_t>(column.name_offset),
+                                         static_cast<size_t>(column.name_size));
+      columns[c].data = reinterpret_cast<const int64_t*>(mapped + static_cast<size_t>(column.data_offset));
+      columns[c].size = static_cast<size_t>(column.size);
+    }
+    return true;
+  }
+
+  const char* mapped = nullptr;
+  size_t mapped_size = 0;
+  std::vector<int64_t> buffer;  // holds the file if it is not mapped
+  std::vector<Column> columns;
+};
+
+#endif
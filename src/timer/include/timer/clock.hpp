@@ -0,0 +1,366 @@
+/**
+ * @file clock.hpp
+ * @brief Implements the clock policies all timers are templated on: the
+ * SteadyClock (std::chrono) and the TscClock which reads the invariant time
+ * stamp counter of x86 cpus and converts the ticks into PreciseTime only when
+ * the results are reported.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef TIMER_CLOCK_H
+#define TIMER_CLOCK_H
+
+#include "precise_time.hpp"
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+// Define TIMER_CLOCK_NO_TSC to let the TscClock always use the steady clock.
+#if !defined(TIMER_CLOCK_NO_TSC)
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TIMER_CLOCK_TSC
+#include <cpuid.h>
+#include <x86intrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define TIMER_CLOCK_TSC
+#include <intrin.h>
+#endif
+#endif
+
+/**
+ * @brief The clock policy on top of std::chrono: the high_resolution_clock if
+ * it is steady, the steady_clock otherwise. A tick is one nanosecond.
+ *
+ * A clock policy provides:
+ * - time_point: what start() and stop() return.
+ * - start() and stop(): read the clock at the begin and at the end of a
+ *   measurement.
+ * - elapsedTicks(begin, end): the raw distance in ticks, cheap enough to be
+ *   taken on each stop.
+ * - toNanoseconds(ticks), toNanoseconds(first, last) and toPreciseTime(ticks):
+ *   the conversion, done when the results are reported.
+ * - TICKS_ARE_NANOSECONDS: true if the conversion can be skipped.
+ */
+struct SteadyClock {
+  using clock      = PreciseTime::PrecisionClock;
+  using time_point = clock::time_point;
+
+  static constexpr bool TICKS_ARE_NANOSECONDS = true;
+
+  static time_point start() noexcept { return clock::now(); }
+  static time_point stop() noexcept { return clock::now(); }
+
+  static int64_t elapsedTicks(const time_point& begin, const time_point& end) noexcept {
+    return static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+  }
+
+  static int64_t toNanoseconds(int64_t ticks) noexcept { return ticks; }
+  static void toNanoseconds(int64_t* /*first*/, int64_t* /*last*/) noexcept {}
+
+  static PreciseTime toPreciseTime(int64_t ticks) noexcept {
+    return std::chrono::nanoseconds(ticks);
+  }
+
+  static PreciseTime elapsed(const time_point& begin, const time_point& end) noexcept {
+    return toPreciseTime(elapsedTicks(begin, end));
+  }
+};
+
+namespace tsc {
+
+/**
+ * @brief A time stamp counter reading together with the steady clock.
+ */
+struct Sample {
+  uint64_t ticks = 0;
+  int64_t nanos  = 0;
+};
+
+inline int64_t steadyNanoseconds() noexcept {
+  return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                SteadyClock::clock::now().time_since_epoch())
+                                .count());
+}
+
+#if defined(TIMER_CLOCK_TSC)
+/**
+ * @brief Calls cpuid, returns false if the leaf is not supported.
+ */
+inline bool cpuid(uint32_t leaf, uint32_t& edx) noexcept {
+  constexpr uint32_t EXTENDED = 0x80000000U;
+#if defined(_MSC_VER) && !defined(__clang__)
+  int regs[4] = {0, 0, 0, 0};
+  __cpuid(regs, static_cast<int>(leaf & EXTENDED));
+  if (static_cast<uint32_t>(regs[0]) < leaf) {
+    return false;
+  }
+  __cpuid(regs, static_cast<int>(leaf));
+  edx = static_cast<uint32_t>(regs[3]);
+  return true;
+#else
+  if (__get_cpuid_max(leaf & EXTENDED, nullptr) < leaf) {
+    return false;
+  }
+  unsigned int eax = 0;
+  unsigned int ebx = 0;
+  unsigned int ecx = 0;
+  unsigned int edx_ = 0;
+  __cpuid(leaf, eax, ebx, ecx, edx_);
+  edx = edx_;
+  return true;
+#endif
+}
+
+/**
+ * @brief True if the counter runs at a constant rate in all power states
+ * (cpuid 0x80000007, edx bit 8), only then ticks can be converted to time.
+ */
+inline bool isInvariant() noexcept {
+  constexpr uint32_t INVARIANT_TSC = 1U << 8U;
+  uint32_t edx                     = 0;
+  return cpuid(0x80000007U, edx) && (edx & INVARIANT_TSC) != 0;
+}
+
+/**
+ * @brief True if rdtscp is supported (cpuid 0x80000001, edx bit 27).
+ */
+inline bool hasRdtscp() noexcept {
+  constexpr uint32_t RDTSCP = 1U << 27U;
+  uint32_t edx              = 0;
+  return cpuid(0x80000001U, edx) && (edx & RDTSCP) != 0;
+}
+
+/**
+ * @brief Reads the counter at the begin of a measurement: the fences keep
+ * earlier instructions from finishing after and later instructions from
+ * starting before the read.
+ */
+inline uint64_t readStart() noexcept {
+  _mm_lfence();
+  const uint64_t ticks = __rdtsc();
+  _mm_lfence();
+  return ticks;
+}
+
+/**
+ * @brief Reads the counter at the end of a measurement: rdtscp waits until
+ * the measured instructions are done, the fence keeps later instructions from
+ * starting before the read.
+ */
+inline uint64_t readStop(bool rdtscp) noexcept {
+  if (!rdtscp) {
+    return readStart();
+  }
+  unsigned int aux     = 0;
+  const uint64_t ticks = __rdtscp(&aux);
+  _mm_lfence();
+  return ticks;
+}
+
+/**
+ * @brief Reads the counter and the steady clock as close together as
+ * possible: the counter is read before and after the clock and the tightest
+ * of a few tries is taken.
+ */
+inline Sample sample() noexcept {
+  constexpr int NUM_TRIES = 8;
+  Sample best;
+  uint64_t best_window = std::numeric_limits<uint64_t>::max();
+  for (int i = 0; i < NUM_TRIES; ++i) {
+    const uint64_t before = readStart();
+    const int64_t nanos   = steadyNanoseconds();
+    const uint64_t after  = readStart();
+    if (after - before < best_window) {
+      best_window = after - before;
+      best.ticks  = before + (after - before) / 2;
+      best.nanos  = nanos;
+    }
+  }
+  return best;
+}
+#else
+inline bool isInvariant() noexcept { return false; }
+inline bool hasRdtscp() noexcept { return false; }
+inline uint64_t readStart() noexcept { return 0; }
+inline uint64_t readStop(bool /*rdtscp*/) noexcept { return 0; }
+inline Sample sample() noexcept { return {}; }
+#endif
+
+}  // namespace tsc
+
+/**
+ * @brief The clock policy reading the time stamp counter with rdtsc/rdtscp,
+ * which is cheaper than the steady clock and does not round to its
+ * resolution. The counter is only used if it is invariant, otherwise (or if
+ * the cpu is no x86) the ticks are the nanoseconds of the steady clock.
+ *
+ * The first use reads the counter together with the steady clock, the second
+ * reading for the ratio of nanoseconds to ticks is taken on the first
+ * conversion, at least CALIBRATION_TIME later (the first conversion waits for
+ * the rest). The ratio stays fixed afterwards, so all conversions agree.
+ * Call calibrate() at startup to pay for this up front.
+ */
+class TscClock {
+ public:
+  /// The raw counter value (or steady clock nanoseconds in the fallback).
+  struct time_point {
+    uint64_t ticks = 0;
+  };
+
+  static constexpr bool TICKS_ARE_NANOSECONDS = false;
+
+  /// How long the counter is compared with the steady clock.
+  static constexpr std::chrono::milliseconds CALIBRATION_TIME{20};
+
+  /// Fixed point fraction bits of the nanoseconds per tick.
+  static constexpr int FRACTION_BITS = 32;
+
+  /**
+   * @brief The conversion of ticks into nanoseconds.
+   */
+  struct Calibration {
+    /// True if the ticks are time stamp counter cycles.
+    bool tsc = false;
+    /// Nanoseconds per tick * 2^FRACTION_BITS.
+    int64_t nanos_per_tick = int64_t{1} << FRACTION_BITS;
+
+    /**
+     * @brief Returns the ticks per second, the counter frequency.
+     */
+    double ticksPerSecond() const noexcept {
+      constexpr double NANOS_PER_SECOND = 1e9;
+      return NANOS_PER_SECOND * static_cast<double>(int64_t{1} << FRACTION_BITS) /
+             static_cast<double>(nanos_per_tick);
+    }
+  };
+
+  static time_point start() noexcept {
+    const State& s = state();
+    if (s.tsc) {
+      return {tsc::readStart()};
+    }
+    return {static_cast<uint64_t>(tsc::steadyNanoseconds())};
+  }
+
+  static time_point stop() noexcept {
+    const State& s = state();
+    if (s.tsc) {
+      return {tsc::readStop(s.rdtscp)};
+    }
+    return {static_cast<uint64_t>(tsc::steadyNanoseconds())};
+  }
+
+  static int64_t elapsedTicks(const time_point& begin, const time_point& end) noexcept {
+    return static_cast<int64_t>(end.ticks - begin.ticks);
+  }
+
+  /**
+   * @brief Returns true if the time stamp counter is used, false if the
+   * steady clock is used instead.
+   */
+  static bool usesTsc() noexcept { return state().tsc; }
+
+  /**
+   * @brief Returns the calibration, on the first call it is computed.
+   */
+  static const Calibration& calibrate() noexcept {
+    static const Calibration calibration = computeCalibration();
+    return calibration;
+  }
+
+  /**
+   * @brief Converts ticks into nanoseconds (rounded, saturating).
+   */
+  static int64_t toNanoseconds(int64_t ticks) noexcept {
+    return scale(ticks, calibrate().nanos_per_tick);
+  }
+
+  /**
+   * @brief Converts all ticks in [first, last) into nanoseconds in place.
+   */
+  static void toNanoseconds(int64_t* first, int64_t* last) noexcept {
+    const int64_t nanos_per_tick = calibrate().nanos_per_tick;
+    for (; first != last; ++first) {
+      *first = scale(*first, nanos_per_tick);
+    }
+  }
+
+  static PreciseTime toPreciseTime(int64_t ticks) noexcept {
+    return std::chrono::nanoseconds(toNanoseconds(ticks));
+  }
+
+  static PreciseTime elapsed(const time_point& begin, const time_point& end) noexcept {
+    return toPreciseTime(elapsedTicks(begin, end));
+  }
+
+ private:
+  struct State {
+    bool tsc    = false;
+    bool rdtscp = false;
+    tsc::Sample anchor;
+  };
+
+  static const State& state() noexcept {
+    static const State s = []() noexcept {
+      State init;
+      init.tsc    = tsc::isInvariant();
+      init.rdtscp = tsc::hasRdtscp();
+      if (init.tsc) {
+        init.anchor = tsc::sample();
+      }
+      return init;
+    }();
+    return s;
+  }
+
+  static Calibration computeCalibration() noexcept {
+    using int128   = wide_int::int128;
+    const State& s = state();
+    Calibration calibration;
+    if (!s.tsc) {
+      return calibration;
+    }
+    const auto waited = std::chrono::nanoseconds(tsc::steadyNanoseconds() - s.anchor.nanos);
+    if (waited < CALIBRATION_TIME) {
+      std::this_thread::sleep_for(CALIBRATION_TIME - waited);
+    }
+    const tsc::Sample now = tsc::sample();
+    const uint64_t ticks  = now.ticks - s.anchor.ticks;
+    if (ticks == 0 || now.nanos <= s.anchor.nanos) {
+      // the counter did not advance, there is nothing to calibrate with
+      return calibration;
+    }
+    const int128 nanos = int128(now.nanos - s.anchor.nanos);
+    const int128 ratio = (nanos * wide_int::pow2<int128>(FRACTION_BITS) + int128(ticks / 2)) /
+                         int128(ticks);
+    calibration.tsc            = true;
+    calibration.nanos_per_tick = static_cast<int64_t>(ratio);
+    return calibration;
+  }
+
+  static int64_t scale(int64_t ticks, int64_t nanos_per_tick) noexcept {
+    using int128         = wide_int::int128;
+    constexpr int64_t HALF = int64_t{1} << (FRACTION_BITS - 1);
+    const int128 product   = int128(ticks) * int128(nanos_per_tick);
+    const int128 rounded =
+      wide_int::divPow2(product + int128(ticks < 0 ? -HALF : HALF), FRACTION_BITS);
+    constexpr int64_t MAX  = std::numeric_limits<int64_t>::max();
+    constexpr int64_t MIN  = std::numeric_limits<int64_t>::min();
+    if (rounded > int128(MAX)) {
+      return MAX;
+    }
+    if (rounded < int128(MIN)) {
+      return MIN;
+    }
+    return static_cast<int64_t>(rounded);
+  }
+};
+
+/// The clock the timers use if none is given.
+using DefaultClock = SteadyClock;
+
+#endif
@@ -12,28 +12,251 @@
 #ifndef COLLECTING_TIMER_H
 #define COLLECTING_TIMER_H
 
+#include "capture_file.hpp"
+#include "clock.hpp"
+#include "compressed_column.hpp"
+#include "log_linear_histogram.hpp"
+#include "parallel.hpp"
 #include "precise_time.hpp"
+#include "precise_time_accumulator.hpp"
+#include "precise_time_column.hpp"
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <fstream>
 #include <iterator>
+#include <limits>
 #include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
-class CollectingTimer {
+template <class Clock>
+class BasicConcurrentCollectingTimer;
+template <class Clock>
+class BasicCallTreeTimer;
+
+/*!
+ * @brief Runs multiple named timers and collects all their measurements.
+ * @tparam Clock The clock policy, see clock.hpp. The measurements are kept in
+ * clock ticks and converted into nanoseconds when results are requested.
+ */
+template <class Clock = DefaultClock>
+class BasicCollectingTimer {
  public:
-  using time_point  = PreciseTime::PrecisionClock::time_point;
-  CollectingTimer() = default;
-  CollectingTimer(const std::vector<PreciseTime>& given_measurements, const std::string label) {
-    measurements[label] = given_measurements;
+  using time_point = typename Clock::time_point;
+
+  /// Handle of a timer, see registerTimer().
+  using TimerId = size_t;
+
+  /*!
+   * @brief How the measurements of a timer are kept.
+   * - SAMPLES: every measurement, memory grows with each stop().
+   * - STREAMING: only count, sum and sum of squares (a PreciseTimeAccumulator),
+   *   min and max: constant memory and a constant time getResult(), but no
+   *   median, outliners, histogram or measurementsToFile().
+   * - HISTOGRAM: like STREAMING plus a LogLinearHistogram: fixed memory, the
+   *   median and the histogram of getResult() come from its buckets, no
+   *   outliners or measurementsToFile().
+   * - WINDOW: only the last measurements in a ring buffer, optionally only
+   *   the ones of the last seconds, see setWindow(): fixed memory, getResult()
+   *   reports the current window, no outliners or measurementsToFile().
+   * - RESERVOIR: like STREAMING plus a uniform random sample of all
+   *   measurements, see setReservoir(): fixed memory, the median, quantiles
+   *   and histogram of getResult() come from the sample, no outliners or
+   *   measurementsToFile().
+   * - COMPRESSED: every measurement in a CompressedColumn, as bit-packed
+   *   differences to its predecessor (1-2 instead of 8 bytes for similar
+   *   measurements): getResult() is exact like for SAMPLES and decodes one
+   *   block at a time, no measurementsToFile() or getPercentiles().
+   */
+  enum class Storage { SAMPLES, STREAMING, HISTOGRAM, WINDOW, RESERVOIR, COMPRESSED };
+
+  /// The number of measurements a WINDOW timer keeps if not set by setWindow().
+  static constexpr size_t DEFAULT_WINDOW_CAPACITY = 1024;
+  /// The number of measurements a RESERVOIR timer samples if not set by setReservoir().
+  static constexpr size_t DEFAULT_RESERVOIR_CAPACITY = 4096;
+  /// The number of empty measurements calibrateOverhead() takes by default.
+  static constexpr size_t DEFAULT_CALIBRATION_RUNS = 10000;
+
+  BasicCollectingTimer() = default;
+
+  /*!
+   * @brief Constructor.
+   * @param storage The Storage of all timers which are registered without
+   * one.
+   */
+  explicit BasicCollectingTimer(Storage storage) : default_storage(storage) {}
+
+  BasicCollectingTimer(const std::vector<PreciseTime>& given_measurements, const std::string label) {
+    Samples& samples      = timers[registerTimer(label)].samples;
+    samples.column        = PreciseTimeColumn(given_measurements);
+    samples.num_converted = given_measurements.size();
+  }
+  BasicCollectingTimer(PreciseTimeColumn&& given_measurements, const std::string& label) {
+    Samples& samples      = timers[registerTimer(label)].samples;
+    samples.num_converted = given_measurements.size();
+    samples.column        = std::move(given_measurements);
+  }
+
+  /*!
+   * @brief Constructor: one SAMPLES timer per column of the capture, the
+   * measurements are copied. To compute the statistics without copying use
+   * getResult(capture, name, result).
+   */
+  explicit BasicCollectingTimer(const CaptureFile& capture) {
+    for (const CaptureFile::Column& column : capture.getColumns()) {
+      Samples& samples = timers[registerTimer(column.name)].samples;
+      samples.column.append(column.data, column.size);
+      samples.num_converted = samples.column.size();
+    }
+  }
+
+  /*!
+   * @brief Returns the handle of the timer with the given name, the timer is
+   * created if it does not exist yet. start(TimerId) and stop(TimerId) index
+   * the timer directly instead of looking the name up on every call.
+   * @param name The name under which the measurements shall be saved.
+   * @return The handle, valid for the lifetime of this instance.
+   */
+  TimerId registerTimer(std::string_view name) {
+    const auto it = timer_ids.find(name);
+    if (it != timer_ids.end()) {
+      return it->second;
+    }
+    const TimerId id = timers.size();
+    timers.emplace_back();
+    timer_ids.emplace(std::string(name), id);
+    setStorage(id, default_storage);
+    return id;
+  }
+
+  /*!
+   * @brief Like registerTimer(name), but the timer keeps its measurements in
+   * the given Storage, see setStorage().
+   */
+  TimerId registerTimer(std::string_view name,
+                        Storage storage,
+                        int significant_digits = LogLinearHistogram::DEFAULT_SIGNIFICANT_DIGITS) {
+    const TimerId id = registerTimer(name);
+    setStorage(id, storage, significant_digits);
+    return id;
+  }
+
+  /*!
+   * @brief Changes how a timer keeps its measurements. Measurements kept as
+   * SAMPLES are folded into the STREAMING statistics or the HISTOGRAM, every
+   * other change drops the measurements.
+   * @param id The handle from registerTimer().
+   * @param storage The new Storage.
+   * @param significant_digits The resolution of the LogLinearHistogram of a
+   * HISTOGRAM timer.
+   */
+  void setStorage(TimerId id,
+                  Storage storage,
+                  int significant_digits = LogLinearHistogram::DEFAULT_SIGNIFICANT_DIGITS) noexcept {
+    if (id >= timers.size()) {
+      return;
+    }
+    Timer& timer = timers[id];
+    if (timer.storage == storage &&
+        (storage != Storage::HISTOGRAM ||
+         timer.histogram->getSignificantDigits() == significant_digits)) {
+      return;
+    }
+    const size_t capacity =
+      storage == Storage::RESERVOIR ? DEFAULT_RESERVOIR_CAPACITY : DEFAULT_WINDOW_CAPACITY;
+    changeStorage(timer, storage, significant_digits, capacity, std::chrono::nanoseconds::zero());
+  }
+
+  /*!
+   * @brief Lets a timer keep only its last measurements (Storage::WINDOW):
+   * the ring buffer is allocated here, stop() never allocates. Mean and
+   * standard deviation are updated on every stop(), exact also when the
+   * oldest measurement is dropped. Measurements kept as SAMPLES are folded
+   * into the window, as if they were recorded now, every other change drops
+   * the measurements.
+   * @param id The handle from registerTimer().
+   * @param capacity The number of measurements kept at most, at least 1.
+   * @param max_age If not 0, measurements stopped longer ago are dropped
+   * too, on stop() and getResult().
+   */
+  void setWindow(TimerId id,
+                 size_t capacity,
+                 std::chrono::nanoseconds max_age = std::chrono::nanoseconds::zero()) noexcept {
+    if (id >= timers.size()) {
+      return;
+    }
+    Timer& timer = timers[id];
+    if (timer.storage == Storage::WINDOW && timer.window.capacity() == std::max<size_t>(capacity, 1) &&
+        timer.window.max_age == max_age) {
+      return;
+    }
+    changeStorage(timer, Storage::WINDOW, LogLinearHistogram::DEFAULT_SIGNIFICANT_DIGITS, capacity, max_age);
+  }
+
+  /*!
+   * @brief Lets a timer keep a uniform random sample of all its measurements
+   * (Storage::RESERVOIR, Algorithm L): every measurement is in the sample
+   * with the same probability, however many there are. The sample is
+   * allocated here, stop() never allocates and draws random numbers only
+   * for the measurements which are taken into the sample, O(capacity *
+   * log(n / capacity)) of n. Count, mean, standard deviation, min and max
+   * are kept exactly as for STREAMING. Measurements kept as SAMPLES are
+   * folded in, every other change drops the measurements.
+   * @param id The handle from registerTimer().
+   * @param capacity The size of the sample, at least 1.
+   */
+  void setReservoir(TimerId id, size_t capacity) noexcept {
+    if (id >= timers.size()) {
+      return;
+    }
+    Timer& timer = timers[id];
+    if (timer.storage == Storage::RESERVOIR && timer.reservoir.capacity == std::max<size_t>(capacity, 1)) {
+      return;
+    }
+    changeStorage(timer,
+                  Storage::RESERVOIR,
+                  LogLinearHistogram::DEFAULT_SIGNIFICANT_DIGITS,
+                  capacity,
+                  std::chrono::nanoseconds::zero());
+  }
+
+  /*!
+   * @brief Preallocates the storage for n measurements of the timer, so the
+   * next n calls to stop() do not allocate. STREAMING, HISTOGRAM and WINDOW
+   * timers never allocate, a COMPRESSED timer only every
+   * CompressedColumn::BLOCK_SIZE-th stop() when its block is packed.
+   * @param id The handle from registerTimer().
+   * @param n The number of measurements.
+   */
+  void reserve(TimerId id, size_t n) {
+    if (id < timers.size() && timers[id].storage == Storage::SAMPLES) {
+      timers[id].samples.column.reserve(n);
+    }
   }
 
   /*!
    * @brief start starts a new measurement.
    * @param s The name under which the measurement/timer shall be saved.
    */
-  void start(const std::string& s = "") noexcept {
-    const time_point start = precisionClock::now();
-    begin_measurements[s]  = start;
+  void start(const std::string& s = "") noexcept { start(registerTimer(s)); }
+
+  /*!
+   * @brief start starts a new measurement.
+   * @param id The handle from registerTimer().
+   */
+  void start(TimerId id) noexcept {
+    if (id >= timers.size()) {
+      // TODO debugMsg: The timer was not registered
+      return;
+    }
+    Timer& timer  = timers[id];
+    timer.started = true;
+    timer.start   = Clock::start();
   }
 
   /*!
@@ -42,18 +265,22 @@ class CollectingTimer {
    * @param s The name under which the measurement/timer shall be saved.
    */
   void stop(const std::string& s = "") noexcept {
-    const time_point stop              = precisionClock::now();
-    const begin_measurements_it start_ = begin_measurements.find(s);
-    if (start_ == begin_measurements.end()) {
+    const time_point stop = Clock::stop();
+    const auto id         = timer_ids.find(s);
+    if (id == timer_ids.end()) {
       // TODO debugMsg: The timer with name s was never started
       return;
     }
-
-    const std::chrono::nanoseconds duration =
-      std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start_->second);
-    measurements[s].emplace_back(duration);
+    record(id->second, stop);
   }
 
+  /*!
+   * @brief Stops a started measurement, computes the time since start()
+   * and saves it. Does not allocate if enough storage was reserved().
+   * @param id The handle from registerTimer().
+   */
+  void stop(TimerId id) noexcept { record(id, Clock::stop()); }
+
   /*!
    * @brief Struckt to hold information about a Histogram.
    */
@@ -124,6 +351,59 @@ class CollectingTimer {
       }
     }
 
+    /*!
+     * @brief Counts the values into the initiated buckets. A value on the
+     * border of two buckets is counted in the lower one, values outside of
+     * all buckets are not counted. The bucket index is computed from the
+     * integer nanoseconds, large inputs are split into chunks which are
+     * counted in parallel.
+     * @param values The values in nanoseconds.
+     * @param n The number of values.
+     * @param skip The values i with skip[i] are not counted (e.g. outliners).
+     * @param max_threads The number of threads to use at most, 1 (the
+     * default) for the calling thread only, 0 for the number of hardware
+     * threads.
+     */
+    void fillBuckets(const int64_t* values,
+                     size_t n,
+                     const std::vector<bool>& skip,
+                     size_t max_threads = 1) {
+      fillBuckets(ContiguousBlocks{values, n}, skip, max_threads);
+    }
+
+    /*!
+     * @brief Like fillBuckets(values, n, skip, max_threads), reads the values
+     * block by block, see ContiguousBlocks.
+     */
+    template <class Blocks>
+    void fillBuckets(const Blocks& blocks, const std::vector<bool>& skip, size_t max_threads = 1) {
+      if (buckets.empty()) {
+        return;
+      }
+      const size_t num_blocks = blocks.numBlocks();
+      const size_t num_chunks = parallel::numChunks(blocks.size(), max_threads, MIN_VALUES_PER_THREAD);
+      std::vector<std::vector<Bucket>> partial(num_chunks - 1, buckets);
+      parallel::forEach(num_chunks, max_threads, [&](size_t c) {
+        std::array<int64_t, Blocks::BUFFER_SIZE> buffer;
+        const size_t end = parallel::chunkBegin(c + 1, num_blocks, num_chunks);
+        for (size_t b = parallel::chunkBegin(c, num_blocks, num_chunks); b < end; ++b) {
+          countIntoBuckets(blocks.block(b, buffer.data()),
+                           blocks.blockSize(b),
+                           b * Blocks::BLOCK_SIZE,
+                           skip,
+                           c == 0 ? buckets : partial[c - 1]);
+        }
+      });
+      for (const auto& counted : partial) {
+        for (size_t b = 0; b < buckets.size(); ++b) {
+          buckets[b].num += counted[b].num;
+        }
+      }
+      for (const auto& bucket : buckets) {
+        max_num_in_bucket = std::max(max_num_in_bucket, bucket.num);
+      }
+    }
+
     /*!
      * @brief Returns a number of white spaces in a speciffic color. Works only
      * in Linux shell.
@@ -178,6 +458,34 @@ class CollectingTimer {
       }
       return color_s + empty_tiles + end;
     }
+
+   private:
+    /*!
+     * @brief Counts the n values into the given copy of the buckets. Bucket
+     * i holds (first + i * size, first + (i + 1) * size], bucket 0 also first
+     * itself.
+     * @param first_index The index of the first value, in skip.
+     */
+    static void countIntoBuckets(const int64_t* values,
+                                 size_t n,
+                                 size_t first_index,
+                                 const std::vector<bool>& skip,
+                                 std::vector<Bucket>& into) noexcept {
+      const int64_t first = PreciseTimeColumn::toNanoseconds(into.front().begin);
+      const int64_t size =
+        PreciseTimeColumn::toNanoseconds(into.front().end) - first;
+      const auto num_buckets = static_cast<uint64_t>(into.size());
+      for (size_t i = 0; i < n; ++i) {
+        if (skip[first_index + i] || values[i] < first) {
+          continue;
+        }
+        const uint64_t distance = static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(first);
+        const uint64_t index = distance == 0 ? 0 : (distance - 1) / static_cast<uint64_t>(size);
+        if (index < num_buckets) {
+          into[static_cast<size_t>(index)].num++;
+        }
+      }
+    }
   };
 
   /*!
@@ -233,6 +541,10 @@ class CollectingTimer {
          << "D{X}: \t  " << r.standard_derivation << "\n"
          << "N measurments: \t" << r.number_measurements << "\n"
          << "N outliners.: \t" << r.number_outliners << "\n";
+      if (r.overhead != PreciseTime::zero()) {
+        os << "Overhead: " << r.overhead << (r.subtracted == r.overhead ? " (subtracted)" : " (included)")
+           << "\n";
+      }
     }
 
     /*!
@@ -430,6 +742,55 @@ class CollectingTimer {
       return os;
     }
 
+    /*!
+     * @brief Returns the value below which the fraction q of the measurements
+     * lie, from the sketch: off by at most 10^-significant digits of the
+     * sketch relative, q = 0 and q = 1 are the exact min and max.
+     * @param q The quantile in [0, 1], e.g. 0.99 for the p99.
+     * @return 0 if there is no sketch (STREAMING timers).
+     */
+    PreciseTime quantile(double q) const noexcept {
+      return sketch ? subtract(sketch->quantile(q), subtracted) : PreciseTime::zero();
+    }
+
+    /*!
+     * @brief Like quantile() for several quantiles at once, e.g.
+     * quantiles({0.5, 0.9, 0.99, 0.999}), in one pass over the sketch.
+     * @return The values in the order of qs.
+     */
+    std::vector<PreciseTime> quantiles(const std::vector<double>& qs) const {
+      if (!sketch) {
+        return std::vector<PreciseTime>(qs.size(), PreciseTime::zero());
+      }
+      std::vector<PreciseTime> values = sketch->quantiles(qs);
+      for (PreciseTime& value : values) {
+        value = subtract(value, subtracted);
+      }
+      return values;
+    }
+
+    /*!
+     * @brief Returns the statistics without the overhead of the measurement
+     * itself, see BasicCollectingTimer::calibrateOverhead(): mean, median,
+     * min, max, the quantiles and the histogram are shifted down by the
+     * overhead (not below 0), the standard deviation and the outliners stay.
+     * This Result keeps the raw values.
+     */
+    Result corrected() const {
+      Result r                 = *this;
+      const PreciseTime shift  = overhead - subtracted;
+      r.min_measurement        = subtract(min_measurement, shift);
+      r.max_measurement        = subtract(max_measurement, shift);
+      r.median                 = subtract(median, shift);
+      r.mean                   = subtract(mean, shift);
+      for (auto& bucket : r.h.buckets) {
+        bucket.begin = subtract(bucket.begin, shift);
+        bucket.end   = subtract(bucket.end, shift);
+      }
+      r.subtracted = overhead;
+      return r;
+    }
+
     std::string timer_name;
     PreciseTime min_measurement = PreciseTime::max();
     PreciseTime max_measurement = PreciseTime::min();
@@ -442,8 +803,68 @@ class CollectingTimer {
     size_t num_char_terminal_width  = 80;
     std::vector<bool> is_outliner;
     Histogram h;
+    /// The quantile sketch of all measurements (outliners included), can be
+    /// merged with the ones of other Results.
+    std::optional<LogLinearHistogram> sketch;
+    /// The calibrated cost of an empty measurement, see calibrateOverhead().
+    PreciseTime overhead = PreciseTime::zero();
+    /// The overhead which is subtracted from the values, 0 for raw ones.
+    PreciseTime subtracted = PreciseTime::zero();
+
+   private:
+    static PreciseTime subtract(const PreciseTime& value, const PreciseTime& shift) noexcept {
+      return value > shift ? value - shift : PreciseTime::zero();
+    }
   };
 
+  /*!
+   * @brief Measures the cost of an empty measurement with this timer type
+   * and its Clock: runs times start(id) directly followed by stop(id) on a
+   * scratch timer. The median is kept as the overhead of this instance, every
+   * Result carries it and Result::corrected() subtracts it. A measurement by
+   * name costs the same, the lookup runs before the start and after the stop
+   * are taken. Calibrate again when the conditions change (e.g. the cpu
+   * frequency), a timer of another Clock calibrates its own.
+   * @param distribution Will contain the statistics of the empty
+   * measurements.
+   * @param runs The number of empty measurements, at least 3.
+   * @return The overhead.
+   */
+  PreciseTime calibrateOverhead(Result& distribution, size_t runs = DEFAULT_CALIBRATION_RUNS) {
+    constexpr size_t NUM_WARM_UP = 100;
+    BasicCollectingTimer scratch;
+    const TimerId id = scratch.registerTimer("overhead");
+    scratch.reserve(id, std::max<size_t>(runs, 3) + NUM_WARM_UP);
+    for (size_t i = 0; i < NUM_WARM_UP; ++i) {
+      scratch.start(id);
+      scratch.stop(id);
+    }
+    scratch.timers[id].samples.column.clear();
+    for (size_t i = 0; i < std::max<size_t>(runs, 3); ++i) {
+      scratch.start(id);
+      scratch.stop(id);
+    }
+    scratch.getResult("overhead", distribution);
+    overhead = distribution.median;
+    return overhead;
+  }
+
+  /*!
+   * @brief Like calibrateOverhead(distribution, runs), without the
+   * statistics.
+   */
+  PreciseTime calibrateOverhead(size_t runs = DEFAULT_CALIBRATION_RUNS) {
+    Result distribution;
+    return calibrateOverhead(distribution, runs);
+  }
+
+  /*!
+   * @brief Sets the overhead of an empty measurement, e.g. calibrated once
+   * for many instances, 0 to report raw values only.
+   */
+  void setOverhead(const PreciseTime& measurement_overhead) noexcept { overhead = measurement_overhead; }
+  PreciseTime getOverhead() const noexcept { return overhead; }
+
   /*!
    * @brief getResult Calculates for the given timer the statics.
    * ! Statistics only make much sense if you have more than 1000 measurements!
@@ -454,151 +875,108 @@ class CollectingTimer {
    * recorded, you have to set this to false.
    * @return false if the name of the
    * given timer doesn't exist or has less than 3 measurements.
+   * A STREAMING timer only fills in mean, min, max, standard deviation and the
+   * number of measurements, in constant time. A HISTOGRAM timer fills in the
+   * median and the histogram from its LogLinearHistogram, the bucket_size is
+   * the one of the bucket holding the median. A WINDOW timer reports the
+   * measurements in its window, without outliners. A RESERVOIR timer reports
+   * the exact count, mean, standard deviation, min and max, the median, the
+   * quantiles and the histogram of its sample, without outliners.
+   * The Result::sketch for the quantiles is built from the measurements or,
+   * for a HISTOGRAM timer, is a copy of its LogLinearHistogram.
+   * Large timers are reduced in chunks on up to getReportThreads() threads.
    */
   bool getResult(const std::string& name, Result& result, bool sort_measurements = true) noexcept {
 
-    const auto timer = measurements.find(name);
-    if (timer == measurements.end()) {
+    const auto id = timer_ids.find(name);
+    if (id == timer_ids.end()) {
       return false;
     }
+    return computeResult(id->first, timers[id->second], result, sort_measurements, report_threads);
+  }
 
-    result.number_measurements = timer->second.size();
-    if (result.number_measurements < 3) {
+  /*!
+   * @brief Calculates the statistics of all timers with measurements on up
+   * to getReportThreads() threads, see getResult(). Every thread takes the
+   * next timer, the threads left over split the large timers into chunks.
+   * @param sort_measurements See getResult().
+   * @return The Results sorted by timer name, independent of the number of
+   * threads. The timer_name is set also for a timer with too few
+   * measurements.
+   */
+  std::vector<Result> getResults(bool sort_measurements = true) {
+    const auto recorded = recordedTimers(true);
+    std::vector<Result> results(recorded.size());
+    const size_t num_threads   = parallel::numThreads(report_threads);
+    const size_t inner_threads = std::max<size_t>(1, num_threads / std::max<size_t>(1, recorded.size()));
+    parallel::forEach(recorded.size(), num_threads, [&](size_t i) {
+      computeResult(*recorded[i].first, *recorded[i].second, results[i], sort_measurements, inner_threads);
+      results[i].timer_name = *recorded[i].first;
+    });
+    return results;
+  }
+
+  /*!
+   * @brief getPercentiles Calculates exact percentiles of the measurements of
+   * the given timer, e.g. {50, 90, 99, 99.9}. The measurements are not
+   * reordered: the first call sorts a copy of them once, later calls read
+   * that sorted view in O(1) per percentile and only merge in the
+   * measurements recorded since. The view costs the memory of a second copy
+   * of the measurements, it also speeds up the median of getResult().
+   * @param name The name of the timer.
+   * @param percents The percentiles in [0, 100], in any order.
+   * @param percentiles Receives the values in the order of percents: the
+   * linear interpolation between the two closest measurements, 50 gives the
+   * median, 0 and 100 the min and the max.
+   * @return false if the name of the given timer doesn't exist, it does not
+   * keep its measurements (STREAMING or HISTOGRAM, see Result::quantiles())
+   * or has none.
+   */
+  bool getPercentiles(const std::string& name,
+                      const std::vector<double>& percents,
+                      std::vector<PreciseTime>& percentiles) {
+    const auto id = timer_ids.find(name);
+    if (id == timer_ids.end()) {
       return false;
     }
-
-    result.is_outliner = std::vector<bool>(result.number_measurements, false);
-
-    if (sort_measurements) {
-      result.median = findMedian(timer->second);
-    } else {
-      result.median = findMedianCopy(timer->second);
+    Samples& samples = timers[id->second].samples;
+    if (timers[id->second].storage != Storage::SAMPLES || samples.column.empty()) {
+      return false;
     }
-
-    auto setMean = [&timer, &result]() {
-      PreciseTime sum;
-      for (size_t i = 0; i < result.number_measurements; ++i) {
-        const auto& measurement = timer->second[i];
-        if (!result.is_outliner[i]) {
-          sum += measurement;
-        }
-      }
-      result.mean =
-        sum / static_cast<double>(result.number_measurements - result.number_outliners);
-    };
-
-    auto setMinMax = [&timer, &result]() {
-      result.max_measurement = PreciseTime::min();
-      result.min_measurement = PreciseTime::max();
-      for (size_t i = 0; i < result.number_measurements; ++i) {
-        const auto& measurement = timer->second[i];
-        if (!result.is_outliner[i]) {
-          if (measurement > result.max_measurement) {
-            result.max_measurement = measurement;
-          }
-          if (measurement < result.min_measurement) {
-            result.min_measurement = measurement;
-          }
-        }
-      }
-    };
-
-    auto setDeviation = [&timer, &result]() {
-      // variance
-      PreciseTime var_sum;
-      var_sum.setExponent(2);
-      for (size_t i = 0; i < result.number_measurements; ++i) {
-        const auto& measurement = timer->second[i];
-        if (!result.is_outliner[i]) {
-          const PreciseTime diff_pt  = measurement - result.mean;
-          var_sum                   += diff_pt * diff_pt;
-        }
-      }
-      PreciseTime variance =
-        var_sum /
-        static_cast<double>(result.number_measurements - result.number_outliners - 1);
-      variance.sqrt();
-      result.standard_derivation = variance;
-    };
-
-    auto setOutliners = [&timer, &result]() {
-      const auto dev_range = result.standard_derivation * result.outliner_range;
-      const auto outliner_distance_top = result.mean + dev_range;
-      const auto outliner_distance_bot = result.mean - dev_range;
-      size_t num_outliners             = 0;
-      for (size_t i = 0; i < result.number_measurements; ++i) {
-        const auto& measurement = timer->second[i];
-        const bool is_otliner =
-          (measurement < outliner_distance_bot || outliner_distance_top < measurement);
-        result.is_outliner[i]  = is_otliner;
-        num_outliners         += is_otliner ? 1 : 0;
-      }
-      result.number_outliners = num_outliners;
-    };
-
-    auto setHistogram = [&timer, &result]() {
-      const size_t number_values = result.number_measurements - result.number_outliners;
-      const auto bucket_size =
-        result.h.scottsRuleBucketSize(number_values, result.standard_derivation);
-      result.h.initBuckets(bucket_size, result.min_measurement, result.max_measurement);
-
-      for (size_t i = 0; i < result.number_measurements; ++i) {
-        const auto& measurement = timer->second[i];
-        if (!result.is_outliner[i]) {
-          for (auto& bucket : result.h.buckets) {
-            if (bucket.begin <= measurement && measurement <= bucket.end) {
-              bucket.num++;
-              break;
-            }
-          }
-        }
-      }
-
-      for (const auto& bucket : result.h.buckets) {
-        result.h.max_num_in_bucket = std::max(result.h.max_num_in_bucket, bucket.num);
-      }
-    };
-
-    result.timer_name = name;
-
-    // default deviation is maximal -> all values are inside outliner_range *
-    // deviation, no outliners
-    setMean();
-    // now we can calculate the deviation estimation
-    setDeviation();
-
-    // detect outliners with deviation
-    if (result.standard_derivation > PreciseTime(std::chrono::nanoseconds(1))) {
-      setOutliners();
-      // estimate a better mean without outliners.
-      setMean();
-      // estimate the deviation without outliners
-      setDeviation();
+    const std::vector<int64_t>& sorted = sortedView(samples);
+    percentiles.clear();
+    percentiles.reserve(percents.size());
+    for (const double percent : percents) {
+      percentiles.push_back(percentileOf(sorted, percent));
     }
-
-    setMinMax();
-
-    setHistogram();
-
     return true;
   }
 
+  /*!
+   * @brief Sets the number of threads getResult(), getResults(),
+   * histogramToFile() and operator<< use at most.
+   * @param num_threads 1 (the default) to compute everything on the calling
+   * thread, 0 for the number of hardware threads. Every report with more
+   * than 1 thread starts its threads anew.
+   */
+  void setReportThreads(size_t num_threads) noexcept { report_threads = num_threads; }
+  size_t getReportThreads() const noexcept { return report_threads; }
+
   /*!
    * @brief Calculates for all saved measurments/timers the statistics and
    * prints them.
    */
-  friend std::ostream& operator<<(std::ostream& os, CollectingTimer& t) {
-    for (const auto& timer : t.measurements) {
-      Result r;
-      t.getResult(timer.first, r);
-      os << "Timer: " << timer.first << std::endl << r << "\n";
+  friend std::ostream& operator<<(std::ostream& os, BasicCollectingTimer& t) {
+    for (const Result& r : t.getResults()) {
+      os << "Timer: " << r.timer_name << std::endl << r << "\n";
     }
     return os;
   }
 
   /*!
    * @brief Writes all measurements from all timers into the given file
-   * (appends) for further analysis with Excel or Matlab.
+   * (appends) for further analysis with Excel or Matlab. STREAMING timers are
+   * left out.
    * @tparam T a std::chrono duration in which the time (as double values)
    * should be printed.
    * @param file_name The name of the file to write into. If its a path, the
@@ -609,7 +987,8 @@ class CollectingTimer {
   template <class T>
   bool measurementsToFile(const std::string& file_name, char seperator) {
 
-    const size_t num_timers = measurements.size();
+    const auto recorded     = recordedTimers(false);
+    const size_t num_timers = recorded.size();
     if (num_timers == 0) {
       return false;
     }
@@ -629,19 +1008,20 @@ class CollectingTimer {
 
     size_t max_num_measurements = 0;
     std::string input_line      = "";
-    for (const auto& timer : measurements) {
-      input_line                    += timer.first + seperator;
-      const size_t num_measurements  = timer.second.size();
+    for (const auto& timer : recorded) {
+      input_line                    += *timer.first + seperator;
+      const size_t num_measurements  = converted(timer.second->samples).size();
       max_num_measurements = std::max(num_measurements, max_num_measurements);
     }
 
     inputIntoFile(input_line);
 
     for (size_t m = 0; m < max_num_measurements; m++) {
-      for (const auto& timer : measurements) {
-        if (timer.second.size() > m) {
-          const double val  = timer.second[m].toDouble<T>();
-          input_line       += std::to_string(val) + seperator;
+      for (const auto& timer : recorded) {
+        if (timer.second->samples.column.size() > m) {
+          const PreciseTime measurement  = timer.second->samples.column[m];
+          const double val               = measurement.toDouble<T>();
+          input_line                    += std::to_string(val) + seperator;
         } else {
           input_line += seperator;
         }
@@ -652,6 +1032,213 @@ class CollectingTimer {
     return file.bad();
   }
 
+  /*!
+   * @brief Parses measurements in the format written by measurementsToFile()
+   * into one std::vector<PreciseTime> per column, without going through
+   * iostreams or allocating per value. The first line holds the timer names,
+   * empty fields are skipped. A column can be handed to
+   * CollectingTimer(columns[i], names[i]).
+   * @tparam T a std::chrono duration in which the values were written.
+   * @param first The begin of the file content.
+   * @param last The end of the file content.
+   * @param seperator The character seperating the fields.
+   * @param names Receives the timer names of the columns.
+   * @param columns Receives the measurements of the columns.
+   * @return true if every field could be parsed.
+   */
+  template <class T>
+  static bool measurementsFromChars(const char* first,
+                                    const char* last,
+                                    char seperator,
+                                    std::vector<std::string>& names,
+                                    std::vector<std::vector<PreciseTime>>& columns) {
+    names.clear();
+    columns.clear();
+    if (first == last) {
+      return false;
+    }
+
+    // calls field(begin, end, index) for every field of the line, returns the
+    // begin of the next line
+    auto forEachField = [last, seperator](const char* line, auto&& field) {
+      const char* line_end = std::find(line, last, '\n');
+      const char* next     = line_end == last ? last : line_end + 1;
+      if (line_end != line && *(line_end - 1) == '\r') {
+        --line_end;
+      }
+      size_t index = 0;
+      for (const char* begin = line;; ++index) {
+        const char* end = std::find(begin, line_end, seperator);
+        if (!field(begin, end, index)) {
+          return static_cast<const char*>(nullptr);
+        }
+        if (end == line_end) {
+          return next;
+        }
+        begin = end + 1;
+      }
+    };
+
+    const char* line = forEachField(first, [&names](const char* begin, const char* end, size_t) {
+      names.emplace_back(begin, end);
+      return true;
+    });
+    columns.resize(names.size());
+    const auto num_lines = static_cast<size_t>(std::count(line, last, '\n')) + 1;
+    for (auto& column : columns) {
+      column.reserve(num_lines);
+    }
+
+    const auto parseField = [&columns](const char* begin, const char* end, size_t index) {
+      while (begin != end && *begin == ' ') {
+        ++begin;
+      }
+      while (begin != end && *(end - 1) == ' ') {
+        --end;
+      }
+      if (begin == end) {
+        return true;
+      }
+      if (index >= columns.size()) {
+        return false;
+      }
+      PreciseTime value;
+      const auto result = PreciseTime::fromChars<T>(begin, end, value);
+      if (result.ec != std::errc() || result.ptr != end) {
+        return false;
+      }
+      columns[index].push_back(value);
+      return true;
+    };
+    while (line != nullptr && line != last) {
+      line = forEachField(line, parseField);
+    }
+    return line != nullptr;
+  }
+
+  /*!
+   * @brief Writes the measurements of all SAMPLES timers into a binary
+   * CaptureFile (overwrites it): exact nanoseconds, no formatting, one write
+   * per timer. Read it with CaptureFile::open().
+   * @param file_name The name of the file to write into. If its a path, the
+   * path must exist.
+   * @return true if writing was successfull.
+   */
+  bool measurementsToCapture(const std::string& file_name) {
+    std::vector<CaptureFile::Column> columns;
+    for (const auto& timer : recordedTimers(false)) {
+      const PreciseTimeColumn& column = converted(timer.second->samples);
+      columns.push_back(CaptureFile::Column{*timer.first, column.data(), column.size()});
+    }
+    return CaptureFile::write(file_name, columns);
+  }
+
+  /*!
+   * @brief Hands out the measurements of all SAMPLES timers recorded since
+   * the last call, e.g. to export them on another thread (see
+   * BasicExporter). Copies the new measurements only, nothing is formatted.
+   * @param batch Receives the timer names and their new measurements in
+   * nanoseconds, timers without new ones are left out. Its memory is reused.
+   * @param keep If false, the measurements are removed from the timer (its
+   * reserved memory is kept), so it does not grow, the statistics then only
+   * cover the measurements recorded since.
+   * @return The number of measurements handed out.
+   */
+  size_t takeNewMeasurements(std::vector<std::pair<std::string, PreciseTimeColumn>>& batch, bool keep = true) {
+    size_t num_batches = 0;
+    size_t num_taken   = 0;
+    for (const auto& timer : recordedTimers(false)) {
+      Samples& samples                = timer.second->samples;
+      const PreciseTimeColumn& column = converted(samples);
+      if (samples.num_taken == column.size()) {
+        continue;
+      }
+      if (num_batches == batch.size()) {
+        batch.emplace_back();
+      }
+      auto& [name, measurements] = batch[num_batches++];
+      name                       = *timer.first;
+      measurements.clear();
+      measurements.append(column.begin() + samples.num_taken, column.size() - samples.num_taken);
+      num_taken += column.size() - samples.num_taken;
+      if (keep) {
+        samples.num_taken = column.size();
+      } else {
+        samples.column.clear();
+        samples.num_converted = 0;
+        samples.num_sorted    = 0;
+        samples.num_taken     = 0;
+      }
+    }
+    batch.resize(num_batches);
+    return num_taken;
+  }
+
+  /*!
+   * @brief Calculates the statistics of a column of a capture like
+   * getResult() does for a SAMPLES timer, directly on the mapped pages. The
+   * capture is only read: the median is selected exactly within the bucket
+   * of the quantile sketch which holds it, so only the measurements of that
+   * bucket are copied.
+   * @param capture The opened capture.
+   * @param name The name of the column.
+   * @param result Will contain the statistical data, is_outliner in the order
+   * of the capture.
+   * @param max_threads The number of threads to use at most, 1 (the
+   * default) for the calling thread only, 0 for the number of hardware
+   * threads.
+   * @return false if there is no such column or it has less than 3
+   * measurements.
+   */
+  static bool getResult(const CaptureFile& capture,
+                        const std::string& name,
+                        Result& result,
+                        size_t max_threads = 1) {
+    result.sketch.reset();
+    result.overhead   = PreciseTime::zero();
+    result.subtracted = PreciseTime::zero();
+    const CaptureFile::Column* column = capture.find(name);
+    if (column == nullptr) {
+      return false;
+    }
+    result.number_measurements = column->size;
+    if (result.number_measurements < 3) {
+      return false;
+    }
+    const ContiguousBlocks blocks{column->data, column->size};
+    setFromMeasurements(name, blocks, result, max_threads);
+    result.median = medianFromSketch(blocks, *result.sketch);
+    return true;
+  }
+
+  /*!
+   * @brief Reads a file written by measurementsToFile() in one go and parses
+   * it with measurementsFromChars().
+   * @tparam T a std::chrono duration in which the values were written.
+   * @param file_name The name of the file to read.
+   * @param seperator The character seperating the fields.
+   * @param names Receives the timer names of the columns.
+   * @param columns Receives the measurements of the columns.
+   * @return true if reading and parsing was successfull.
+   */
+  template <class T>
+  static bool measurementsFromFile(const std::string& file_name,
+                                   char seperator,
+                                   std::vector<std::string>& names,
+                                   std::vector<std::vector<PreciseTime>>& columns) {
+    std::ifstream file(file_name.c_str(), std::ios_base::binary | std::ios_base::ate);
+    if (!file.is_open()) {
+      return false;
+    }
+    std::string content(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    if (!file.read(&content[0], static_cast<std::streamsize>(content.size()))) {
+      return false;
+    }
+    return measurementsFromChars<T>(
+      content.data(), content.data() + content.size(), seperator, names, columns);
+  }
+
   /*!
    * @brief Writes the histogramms of all measurements from all timers into the
    * given file (appends) for further analysis with Excel or Matlab.
@@ -665,17 +1252,11 @@ class CollectingTimer {
   template <class T>
   bool histogramToFile(const std::string& file_name, char seperator) {
 
-    const size_t num_timers = measurements.size();
-    if (num_timers == 0) {
+    const std::vector<Result> results = getResults();
+    if (results.empty()) {
       return false;
     }
 
-    std::vector<Result> results(num_timers);
-    size_t i = 0;
-    for (const auto& timer : measurements) {
-      getResult(timer.first, results[i++]);
-    }
-
     std::ofstream file;
     file.open(file_name.c_str(), std::ios_base::app);
     if (file.bad()) {
@@ -691,26 +1272,34 @@ class CollectingTimer {
     };
 
     size_t max_num_buckets = 0;
+    // the counts are normed by the number of binned measurements, which is
+    // the size of the sample for a RESERVOIR timer
+    std::vector<double> num_binned;
+    num_binned.reserve(results.size());
     for (const auto& result : results) {
       input_line += result.timer_name + " bucket" + seperator +
                     result.timer_name + " count" + seperator;
       const size_t num_buckets = result.h.buckets.size();
       max_num_buckets          = std::max(max_num_buckets, num_buckets);
+      double binned            = 0;
+      for (const auto& bucket : result.h.buckets) {
+        binned += static_cast<double>(bucket.num);
+      }
+      num_binned.push_back(binned);
     }
     inputIntoFile();
 
     for (size_t b = 0; b < max_num_buckets; b++) {
-      for (const auto& result : results) {
+      for (size_t r = 0; r < results.size(); ++r) {
+        const Result& result = results[r];
         if (result.h.buckets.size() > b) {
-          const Histogram::Bucket& bucket = result.h.buckets[b];
-          const double val = bucket.getBucketCenter().toDouble<T>();
-          const double normed_value =
-            static_cast<double>(bucket.num) /
-            static_cast<double>(result.number_measurements - result.number_outliners);
+          const typename Histogram::Bucket& bucket = result.h.buckets[b];
+          const double val = bucket.getBucketCenter().template toDouble<T>();
+          const double normed_value = static_cast<double>(bucket.num) / num_binned[r];
           input_line += std::to_string(val) + seperator +
                         std::to_string(normed_value) + seperator;
         } else {
-          input_line += ' ' + seperator + ' ' + seperator;
+          input_line += std::string(1, ' ') + seperator + ' ' + seperator;
         }
       }
       inputIntoFile();
@@ -720,53 +1309,780 @@ class CollectingTimer {
   }
 
  private:
-  PreciseTime findMedian(std::vector<PreciseTime>& values) noexcept {
-    // https://www.geeksforgeeks.org/finding-median-of-unsorted-array-in-linear-time-using-c-stl/
-    const long int n = static_cast<long int>(values.size());
+  /*!
+   * @brief The measurements of one timer: the first num_converted are in
+   * nanoseconds, the ones after in clock ticks.
+   */
+  struct Samples {
+    PreciseTimeColumn column;
+    size_t num_converted = 0;
+    /// The first num_sorted measurements in nanoseconds, ascending, see
+    /// sortedView(). While num_sorted is 0 the memory is reused as scratch
+    /// buffer.
+    std::vector<int64_t> sorted;
+    size_t num_sorted = 0;
+    /// The first num_taken measurements were handed out by takeNewMeasurements().
+    size_t num_taken = 0;
+  };
+
+  /*!
+   * @brief Finds the median of the n values in linear time, reorders them.
+   * For an even n the left middle value is the largest one left of the right
+   * middle value, so one selection is enough.
+   */
+  static PreciseTime findMedian(int64_t* values, size_t n) noexcept {
+    using ns             = std::chrono::nanoseconds;
+    const size_t mid     = n / 2;
+    const auto mid_index = static_cast<std::ptrdiff_t>(mid);
+    std::nth_element(values, values + mid_index, values + n);
+    if (n % 2 == 1) {
+      return ns(values[mid]);
+    }
+    const int64_t left_mid = *std::max_element(values, values + mid_index);
+    return (PreciseTime(ns(left_mid)) + PreciseTime(ns(values[mid]))) / 2.0;
+  }
+
+  /*!
+   * @brief Returns the median of the measurements. From the sorted view if
+   * there is one (it is brought up to date), else selected in the
+   * measurements themselves if they may be reordered or in the scratch
+   * buffer of the sorted view.
+   */
+  static PreciseTime findMedian(Samples& samples, bool reorder_measurements) {
+    using ns = std::chrono::nanoseconds;
+    if (samples.num_sorted != 0) {
+      const std::vector<int64_t>& sorted = sortedView(samples);
+      const size_t mid                   = sorted.size() / 2;
+      if (sorted.size() % 2 == 1) {
+        return ns(sorted[mid]);
+      }
+      return (PreciseTime(ns(sorted[mid - 1])) + PreciseTime(ns(sorted[mid]))) / 2.0;
+    }
+    PreciseTimeColumn& column = converted(samples);
+    // the measurements not taken yet must stay behind the taken ones
+    const bool taken_in_part = samples.num_taken != 0 && samples.num_taken != column.size();
+    if (reorder_measurements && !taken_in_part) {
+      return findMedian(column.begin(), column.size());
+    }
+    samples.sorted.assign(column.begin(), column.end());
+    return findMedian(samples.sorted.data(), samples.sorted.size());
+  }
+
+  /*!
+   * @brief Brings the sorted view of the measurements up to date: the
+   * measurements recorded since the last call are sorted and merged in, in
+   * O(k log k + n) for k new ones. Without new ones nothing is done.
+   * @return All measurements in nanoseconds, ascending.
+   */
+  static const std::vector<int64_t>& sortedView(Samples& samples) {
+    const PreciseTimeColumn& column = converted(samples);
+    if (samples.num_sorted == column.size()) {
+      return samples.sorted;
+    }
+    // without a view the buffer may hold the scratch of a median selection
+    const size_t num_sorted = samples.num_sorted;
+    samples.sorted.resize(num_sorted);
+    samples.sorted.insert(samples.sorted.end(), column.begin() + num_sorted, column.end());
+    const auto middle = samples.sorted.begin() + static_cast<std::ptrdiff_t>(num_sorted);
+    std::sort(middle, samples.sorted.end());
+    std::inplace_merge(samples.sorted.begin(), middle, samples.sorted.end());
+    samples.num_sorted = column.size();
+    return samples.sorted;
+  }
+
+  /*!
+   * @brief Returns the percentile of the sorted values: the linear
+   * interpolation between the two closest ranks.
+   * @param percent The percentile, clamped to [0, 100].
+   */
+  static PreciseTime percentileOf(const std::vector<int64_t>& sorted, double percent) noexcept {
+    using ns              = std::chrono::nanoseconds;
+    const double position = std::clamp(percent, 0., 100.) / 100. * static_cast<double>(sorted.size() - 1);
+    const auto lower      = static_cast<size_t>(position);
+    const size_t upper    = std::min(lower + 1, sorted.size() - 1);
+    const double fraction = position - static_cast<double>(lower);
+    const PreciseTime low = ns(sorted[lower]);
+    if (fraction == 0. || sorted[upper] == sorted[lower]) {
+      return low;
+    }
+    return low + (PreciseTime(ns(sorted[upper])) - low) * fraction;
+  }
 
-    // If size of the arr[] is even
-    if (n % 2 == 0) {
+  /// Below this many values per thread a timer is not split into chunks.
+  static constexpr size_t MIN_VALUES_PER_THREAD = size_t{1} << 18U;
+
+  /*!
+   * @brief Reads n contiguous measurements in blocks of FUSED_BLOCK_SIZE
+   * without copying. The reductions below take any Blocks with this
+   * interface, e.g. a CompressedColumn, which decodes a block into the
+   * buffer of BUFFER_SIZE values they provide. All blocks but the last are
+   * full.
+   */
+  struct ContiguousBlocks {
+    static constexpr size_t BLOCK_SIZE  = column_kernels::FUSED_BLOCK_SIZE;
+    static constexpr size_t BUFFER_SIZE = 1;
 
-      // Applying nth_element
-      // on n/2th index
-      std::nth_element(values.begin(), values.begin() + n / 2, values.end());
+    const int64_t* data = nullptr;
+    size_t n            = 0;
 
-      // Applying nth_element
-      // on (n-1)/2 th index
-      std::nth_element(values.begin(), values.begin() + (n - 1) / 2, values.end());
+    size_t size() const noexcept { return n; }
+    size_t numBlocks() const noexcept { return (n + BLOCK_SIZE - 1) / BLOCK_SIZE; }
+    size_t blockSize(size_t b) const noexcept { return std::min(BLOCK_SIZE, n - b * BLOCK_SIZE); }
+    const int64_t* block(size_t b, int64_t* /*buffer*/) const noexcept { return data + b * BLOCK_SIZE; }
+  };
 
-      // Find the average of value at
-      // index N/2 and (N-1)/2
-      const size_t right_mid_index = static_cast<size_t>(n / 2);
-      const size_t left_mid_index  = right_mid_index - 1;
-      return (values[left_mid_index] + values[right_mid_index]) / 2.0;
+  /*!
+   * @brief Sets the quantile sketch, mean, standard deviation, min, max and
+   * the outliners of the result in two passes. The first pass computes the
+   * moments, min and max of all measurements with the fused SIMD kernel,
+   * keeps min and max per block and records the block into the sketch of its
+   * chunk while it is in cache. If the deviation is above 1ns, every measurement further than
+   * outliner_range deviations from the mean is an outliner: the second pass
+   * only reads the blocks whose min or max lie outside, and the outliners
+   * are subtracted from the exact sums of the first pass.
+   */
+  template <class Blocks>
+  static void setStatistics(const Blocks& data, Result& result, size_t max_threads) {
+    using column_kernels::Moments;
+    using ns               = std::chrono::nanoseconds;
+    constexpr size_t BLOCK = Blocks::BLOCK_SIZE;
+    std::array<int64_t, Blocks::BUFFER_SIZE> buffer;
+    // the first measurement as offset keeps the distances small for the SIMD kernels
+    const int64_t offset = data.block(0, buffer.data())[0];
+
+    // the blocks are split into chunks which are reduced in parallel
+    const size_t num_blocks = data.numBlocks();
+    std::vector<Moments> blocks(num_blocks);
+    const size_t num_chunks = parallel::numChunks(data.size(), max_threads, MIN_VALUES_PER_THREAD);
+    std::vector<LogLinearHistogram> sketches(num_chunks);
+    parallel::forEach(num_chunks, max_threads, [&](size_t c) {
+      std::array<int64_t, Blocks::BUFFER_SIZE> chunk_buffer;
+      const size_t end = parallel::chunkBegin(c + 1, num_blocks, num_chunks);
+      for (size_t b = parallel::chunkBegin(c, num_blocks, num_chunks); b < end; ++b) {
+        const int64_t* values = data.block(b, chunk_buffer.data());
+        const size_t size     = data.blockSize(b);
+        blocks[b]             = column_kernels::moments(values, size, offset);
+        for (size_t i = 0; i < size; ++i) {
+          sketches[c].record(values[i]);
+        }
+      }
+    });
+    for (size_t c = 1; c < num_chunks; ++c) {
+      sketches[0].merge(sketches[c]);
+    }
+    result.sketch = std::move(sketches[0]);
+    Moments all;
+    std::vector<std::pair<int64_t, int64_t>> block_min_max;
+    block_min_max.reserve(num_blocks);
+    for (const Moments& block : blocks) {
+      block_min_max.emplace_back(block.min, block.max);
+      all.merge(block);
     }
 
-    // If size of the arr[] is odd
-    else {
+    auto setMeanAndDeviation = [&result, offset](const Moments& moments) {
+      const auto acc = PreciseTimeAccumulator::fromMoments(moments, offset);
+      result.mean                = acc.mean();
+      result.standard_derivation = acc.standardDeviation();
+    };
+    auto setMinMax = [&result](int64_t min, int64_t max) {
+      const bool none        = min > max;
+      result.min_measurement = none ? PreciseTime::max() : PreciseTime(ns(min));
+      result.max_measurement = none ? PreciseTime::min() : PreciseTime(ns(max));
+    };
 
-      // Applying nth_element
-      // on n/2
-      nth_element(values.begin(), values.begin() + n / 2, values.end());
+    // default deviation is maximal -> all values are inside outliner_range *
+    // deviation, no outliners
+    setMeanAndDeviation(all);
+    if (result.standard_derivation <= PreciseTime(std::chrono::nanoseconds(1))) {
+      setMinMax(all.min, all.max);
+      return;
+    }
 
-      // Value at index (N/2)th
-      // is the median
-      const size_t mid_index = static_cast<size_t>(n / 2);
-      return values[mid_index];
+    // detect outliners with deviation
+    const auto dev_range = result.standard_derivation * result.outliner_range;
+    const int64_t lo     = PreciseTimeColumn::toNanoseconds(result.mean - dev_range);
+    const int64_t hi     = PreciseTimeColumn::toNanoseconds(result.mean + dev_range);
+    Moments outliners;
+    int64_t min = std::numeric_limits<int64_t>::max();
+    int64_t max = std::numeric_limits<int64_t>::min();
+    for (size_t b = 0; b < block_min_max.size(); ++b) {
+      if (lo <= block_min_max[b].first && block_min_max[b].second <= hi) {
+        min = std::min(min, block_min_max[b].first);
+        max = std::max(max, block_min_max[b].second);
+        continue;
+      }
+      const int64_t* values = data.block(b, buffer.data());
+      const size_t size     = data.blockSize(b);
+      for (size_t i = 0; i < size; ++i) {
+        if (values[i] < lo || hi < values[i]) {
+          result.is_outliner[b * BLOCK + i] = true;
+          outliners.add(values[i], offset);
+        } else {
+          min = std::min(min, values[i]);
+          max = std::max(max, values[i]);
+        }
+      }
     }
+    result.number_outliners = outliners.count;
+
+    // estimate a better mean and deviation without outliners.
+    all.remove(outliners);
+    setMeanAndDeviation(all);
+    setMinMax(min, max);
   }
 
-  PreciseTime findMedianCopy(std::vector<PreciseTime> values) {
-    return findMedian(values);
+  /*!
+   * @brief Converts the measurements taken since the last call from clock
+   * ticks into nanoseconds.
+   * @return The column, all in nanoseconds.
+   */
+  static PreciseTimeColumn& converted(Samples& samples) noexcept {
+    if constexpr (!Clock::TICKS_ARE_NANOSECONDS) {
+      Clock::toNanoseconds(samples.column.begin() + samples.num_converted, samples.column.end());
+    }
+    samples.num_converted = samples.column.size();
+    return samples.column;
   }
 
-  typedef std::conditional<std::chrono::high_resolution_clock::is_steady,
-                           std::chrono::high_resolution_clock,
-                           std::chrono::steady_clock>::type precisionClock;
+  /*!
+   * @brief The statistics of a STREAMING timer, in nanoseconds.
+   */
+  struct Streaming {
+    PreciseTimeAccumulator accumulator;
+    int64_t min = std::numeric_limits<int64_t>::max();
+    int64_t max = std::numeric_limits<int64_t>::min();
+
+    void add(int64_t nanos) noexcept {
+      accumulator.add(nanos);
+      min = std::min(min, nanos);
+      max = std::max(max, nanos);
+    }
+  };
+
+  /*!
+   * @brief The last measurements of a WINDOW timer in a ring buffer, in
+   * nanoseconds, and their running sums. All memory is allocated by init().
+   */
+  struct Window {
+    std::vector<int64_t> nanos;     // the ring buffer
+    std::vector<time_point> stops;  // when the measurements were stopped, only with a max_age
+    std::vector<int64_t> scratch;   // the window in order, for getResult()
+    size_t first = 0;               // the oldest measurement
+    size_t size  = 0;
+    std::chrono::nanoseconds max_age{0};
+    PreciseTimeAccumulator accumulator;
+
+    void init(size_t capacity, std::chrono::nanoseconds age) {
+      nanos.assign(std::max<size_t>(capacity, 1), 0);
+      stops.assign(age.count() > 0 ? nanos.size() : 0, time_point{});
+      scratch.reserve(nanos.size());
+      max_age = age;
+    }
+
+    size_t capacity() const noexcept { return nanos.size(); }
 
-  std::map<std::string, time_point> begin_measurements;
-  typedef std::map<std::string, time_point>::iterator begin_measurements_it;
-  std::map<std::string, std::vector<PreciseTime>> measurements;
+    void add(int64_t value, const time_point& stop) noexcept {
+      if (size == nanos.size()) {
+        dropOldest();
+      }
+      size_t i = first + size;
+      if (i >= nanos.size()) {
+        i -= nanos.size();
+      }
+      nanos[i] = value;
+      if (!stops.empty()) {
+        stops[i] = stop;
+      }
+      ++size;
+      accumulator.add(value);
+      dropOlderThan(stop);
+    }
+
+    void dropOldest() noexcept {
+      accumulator.remove(nanos[first]);
+      first = first + 1 == nanos.size() ? 0 : first + 1;
+      --size;
+    }
+
+    /*!
+     * @brief Drops the measurements stopped more than max_age before now.
+     */
+    void dropOlderThan(const time_point& now) noexcept {
+      if (stops.empty()) {
+        return;
+      }
+      while (size > 0 && Clock::toNanoseconds(Clock::elapsedTicks(stops[first], now)) > max_age.count()) {
+        dropOldest();
+      }
+    }
+
+    /*!
+     * @brief Copies the window, oldest first, into the scratch buffer.
+     */
+    std::vector<int64_t>& ordered() noexcept {
+      const size_t wrapped = std::min(size, nanos.size() - first);
+      scratch.assign(nanos.begin() + static_cast<std::ptrdiff_t>(first),
+                     nanos.begin() + static_cast<std::ptrdiff_t>(first + wrapped));
+      scratch.insert(scratch.end(), nanos.begin(), nanos.begin() + static_cast<std::ptrdiff_t>(size - wrapped));
+      return scratch;
+    }
+  };
+
+  /*!
+   * @brief The uniform random sample of a RESERVOIR timer, in nanoseconds,
+   * drawn with Algorithm L (Li, 1994): after the sample is full, the number
+   * of measurements to skip until the next one is taken is drawn at once, so
+   * most add() calls only count. All memory is allocated by init().
+   */
+  struct Reservoir {
+    std::vector<int64_t> nanos;    // the sample
+    std::vector<int64_t> scratch;  // a copy for getResult()
+    size_t capacity = 0;
+    uint64_t seen   = 0;  // the number of measurements offered
+    uint64_t next   = 0;  // the number of the next measurement taken
+    double w        = 1.;
+    uint64_t random_state = 0x9E3779B97F4A7C15ULL;  // fixed seed for repeatable runs
+
+    void init(size_t size) {
+      capacity = std::max<size_t>(size, 1);
+      nanos.reserve(capacity);
+      scratch.reserve(capacity);
+    }
+
+    void add(int64_t value) noexcept {
+      ++seen;
+      if (nanos.size() < capacity) {
+        nanos.push_back(value);
+        if (nanos.size() == capacity) {
+          w = std::exp(std::log(uniform()) / static_cast<double>(capacity));
+          skip();
+        }
+        return;
+      }
+      if (seen != next) {
+        return;
+      }
+      const auto slot = static_cast<size_t>(uniform() * static_cast<double>(capacity));
+      nanos[std::min(slot, capacity - 1)] = value;
+      w *= std::exp(std::log(uniform()) / static_cast<double>(capacity));
+      skip();
+    }
+
+    /*!
+     * @brief Draws the number of the next measurement which is taken.
+     */
+    void skip() noexcept {
+      constexpr uint64_t MAX_GAP = uint64_t{1} << 62U;
+      const double gap           = std::floor(std::log(uniform()) / std::log1p(-w));
+      next = seen + 1 + (gap < static_cast<double>(MAX_GAP) ? static_cast<uint64_t>(gap) : MAX_GAP);
+    }
+
+    /*!
+     * @brief A uniform random number in (0, 1) from splitmix64.
+     */
+    double uniform() noexcept {
+      random_state += 0x9E3779B97F4A7C15ULL;
+      uint64_t z = random_state;
+      z          = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+      z          = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+      z          = z ^ (z >> 31U);
+      constexpr double TWO_POW_MINUS_53 = 1. / static_cast<double>(uint64_t{1} << 53U);
+      return (static_cast<double>(z >> 11U) + 0.5) * TWO_POW_MINUS_53;
+    }
+  };
+
+  /*!
+   * @brief A registered timer: the start of the running measurement and all
+   * finished ones.
+   */
+  struct Timer {
+    time_point start{};
+    bool started    = false;
+    Storage storage = Storage::SAMPLES;
+    Samples samples;
+    Streaming streaming;
+    std::optional<LogLinearHistogram> histogram;  // only for HISTOGRAM
+    Window window;                                // only for WINDOW
+    Reservoir reservoir;                          // only for RESERVOIR
+    CompressedColumn compressed;                  // only for COMPRESSED
+
+    bool hasMeasurements() const noexcept {
+      if (storage == Storage::SAMPLES) {
+        return !samples.column.empty();
+      }
+      if (storage == Storage::COMPRESSED) {
+        return !compressed.empty();
+      }
+      if (storage == Storage::WINDOW) {
+        return window.size > 0;
+      }
+      return streaming.accumulator.getCount() > 0;
+    }
+
+    /*!
+     * @brief Saves one measurement given in clock ticks.
+     * @param stop When the measurement was stopped.
+     */
+    void add(int64_t ticks, const time_point& stop) noexcept {
+      if (storage == Storage::SAMPLES) {
+        // stored in ticks, converted when the results are requested
+        samples.column.push_back(std::chrono::nanoseconds(ticks));
+      } else {
+        addNanoseconds(Clock::toNanoseconds(ticks), stop);
+      }
+    }
+
+    /*!
+     * @brief Saves one measurement of a STREAMING, HISTOGRAM, WINDOW,
+     * RESERVOIR or COMPRESSED timer.
+     */
+    void addNanoseconds(int64_t nanos, const time_point& stop) noexcept {
+      if (storage == Storage::WINDOW) {
+        window.add(nanos, stop);
+        return;
+      }
+      if (storage == Storage::COMPRESSED) {
+        compressed.push_back(nanos);
+        return;
+      }
+      streaming.add(nanos);
+      if (storage == Storage::HISTOGRAM) {
+        histogram->record(nanos);
+      } else if (storage == Storage::RESERVOIR) {
+        reservoir.add(nanos);
+      }
+    }
+  };
+
+  void record(TimerId id, const time_point& stop) noexcept {
+    if (id >= timers.size() || !timers[id].started) {
+      // TODO debugMsg: The timer was never started
+      return;
+    }
+    Timer& timer = timers[id];
+    timer.add(Clock::elapsedTicks(timer.start, stop), stop);
+  }
+
+  /*!
+   * @brief Appends measurements in clock ticks, e.g. recorded by another
+   * thread. A WINDOW timer takes them as stopped now.
+   */
+  void append(TimerId id, const PreciseTimeColumn& ticks) {
+    Timer& timer = timers[id];
+    if (timer.storage == Storage::SAMPLES) {
+      timer.samples.column.append(ticks);
+    } else {
+      const time_point now = Clock::stop();
+      for (const int64_t tick : ticks) {
+        timer.add(tick, now);
+      }
+    }
+  }
+
+  /*!
+   * @brief Sets the new Storage of the timer, folds the measurements kept as
+   * SAMPLES into it and drops all others.
+   */
+  static void changeStorage(Timer& timer,
+                            Storage storage,
+                            int significant_digits,
+                            size_t capacity,
+                            std::chrono::nanoseconds max_age) noexcept {
+    Samples samples;
+    if (timer.storage == Storage::SAMPLES) {
+      converted(timer.samples);
+      samples = std::move(timer.samples);
+    }
+    timer.samples    = Samples{};
+    timer.streaming  = Streaming{};
+    timer.histogram.reset();
+    timer.window     = Window{};
+    timer.reservoir  = Reservoir{};
+    timer.compressed = CompressedColumn{};
+    timer.storage    = storage;
+    if (storage == Storage::SAMPLES) {
+      return;
+    }
+    if (storage == Storage::HISTOGRAM) {
+      timer.histogram.emplace(significant_digits);
+    }
+    if (storage == Storage::WINDOW) {
+      timer.window.init(capacity, max_age);
+    }
+    if (storage == Storage::RESERVOIR) {
+      timer.reservoir.init(capacity);
+    }
+    const time_point now = Clock::stop();
+    for (const int64_t nanos : samples.column) {
+      timer.addNanoseconds(nanos, now);
+    }
+  }
+
+  /*!
+   * @brief Calculates the statistics of the timer, see getResult(). Only
+   * touches the given timer, so it can run for several timers in parallel.
+   * @param max_threads The number of threads a large timer is split on.
+   */
+  bool computeResult(const std::string& name,
+                     Timer& timer,
+                     Result& result,
+                     bool sort_measurements,
+                     size_t max_threads) noexcept {
+    result.sketch.reset();
+    result.overhead   = overhead;
+    result.subtracted = PreciseTime::zero();
+    if (timer.storage == Storage::STREAMING) {
+      return getStreamingResult(name, timer.streaming, result);
+    }
+    if (timer.storage == Storage::HISTOGRAM) {
+      return getHistogramResult(name, timer, result);
+    }
+    if (timer.storage == Storage::WINDOW) {
+      return getWindowResult(name, timer.window, result);
+    }
+    if (timer.storage == Storage::RESERVOIR) {
+      return getReservoirResult(name, timer, result);
+    }
+    if (timer.storage == Storage::COMPRESSED) {
+      result.number_measurements = timer.compressed.size();
+      if (result.number_measurements < 3) {
+        return false;
+      }
+      setFromMeasurements(name, timer.compressed, result, max_threads);
+      result.median = medianFromSketch(timer.compressed, *result.sketch);
+      return true;
+    }
+    PreciseTimeColumn& column = converted(timer.samples);
+
+    result.number_measurements = column.size();
+    if (result.number_measurements < 3) {
+      return false;
+    }
+
+    // may reorder the measurements, the outliners are marked afterwards
+    result.median = findMedian(timer.samples, sort_measurements);
+
+    setFromMeasurements(name, ContiguousBlocks{column.begin(), column.size()}, result, max_threads);
+
+    return true;
+  }
+
+  /*!
+   * @brief Sets everything of the Result but the median from the n >= 3
+   * measurements: the sketch, the statistics, the outliners and the
+   * histogram.
+   * @param data The measurements, see ContiguousBlocks.
+   */
+  template <class Blocks>
+  static void setFromMeasurements(const std::string& name,
+                                  const Blocks& data,
+                                  Result& result,
+                                  size_t max_threads) {
+    const size_t n             = data.size();
+    result.number_measurements = n;
+    result.is_outliner         = std::vector<bool>(n, false);
+
+    auto setHistogram = [&data, &result, max_threads]() {
+      const size_t number_values = result.number_measurements - result.number_outliners;
+      const auto bucket_size =
+        result.h.scottsRuleBucketSize(number_values, result.standard_derivation);
+      result.h.initBuckets(bucket_size, result.min_measurement, result.max_measurement);
+      result.h.fillBuckets(data, result.is_outliner, max_threads);
+    };
+
+    result.timer_name = name;
+
+    setStatistics(data, result, max_threads);
+
+    setHistogram();
+  }
+
+  /*!
+   * @brief Finds the exact median of the n values without changing them:
+   * the sketch of all values tells in which of its buckets the middle
+   * ranks lie, one pass copies the values of those buckets, the median is
+   * selected among them.
+   * @param data The measurements, see ContiguousBlocks.
+   */
+  template <class Blocks>
+  static PreciseTime medianFromSketch(const Blocks& data, const LogLinearHistogram& sketch) {
+    using ns       = std::chrono::nanoseconds;
+    const size_t n = data.size();
+    // the 0 based ranks of the middle values and the buckets holding them
+    const std::array<uint64_t, 2> ranks = {(n - 1) / 2, n / 2};
+    std::array<size_t, 2> buckets{};
+    std::array<uint64_t, 2> below{};
+    uint64_t seen = 0;
+    size_t r      = 0;
+    for (size_t i = 0; i < sketch.numBuckets() && r < ranks.size(); ++i) {
+      const uint64_t count = sketch.countAt(i);
+      for (; r < ranks.size() && ranks[r] < seen + count; ++r) {
+        buckets[r] = i;
+        below[r]   = seen;
+      }
+      seen += count;
+    }
+    std::vector<int64_t> candidates;
+    std::array<int64_t, Blocks::BUFFER_SIZE> buffer;
+    for (size_t b = 0; b < data.numBlocks(); ++b) {
+      const int64_t* values = data.block(b, buffer.data());
+      const size_t size     = data.blockSize(b);
+      for (size_t i = 0; i < size; ++i) {
+        const size_t bucket = sketch.indexOf(values[i]);
+        if (bucket == buckets[0] || bucket == buckets[1]) {
+          candidates.push_back(values[i]);
+        }
+      }
+    }
+    // the candidates are the values of ranks [below[0], below[0] + size)
+    auto select = [&candidates, &below](uint64_t rank) {
+      const auto nth = candidates.begin() + static_cast<std::ptrdiff_t>(rank - below[0]);
+      std::nth_element(candidates.begin(), nth, candidates.end());
+      return *nth;
+    };
+    const int64_t right = select(ranks[1]);
+    if (ranks[0] == ranks[1]) {
+      return ns(right);
+    }
+    const int64_t left = select(ranks[0]);
+    return (PreciseTime(ns(left)) + PreciseTime(ns(right))) / 2.0;
+  }
+
+
+  static bool getStreamingResult(const std::string& name,
+                                 const Streaming& streaming,
+                                 Result& result) noexcept {
+    result.timer_name          = name;
+    // saturates on 32 bit, a count above SIZE_MAX is not representable
+    result.number_measurements = static_cast<size_t>(
+      std::min<uint64_t>(streaming.accumulator.getCount(), std::numeric_limits<size_t>::max()));
+    if (result.number_measurements < 3) {
+      return false;
+    }
+    result.mean                = streaming.accumulator.mean();
+    result.standard_derivation = streaming.accumulator.standardDeviation();
+    result.min_measurement     = std::chrono::nanoseconds(streaming.min);
+    result.max_measurement     = std::chrono::nanoseconds(streaming.max);
+    return true;
+  }
+
+  static bool getHistogramResult(const std::string& name, const Timer& timer, Result& result) {
+    if (!getStreamingResult(name, timer.streaming, result)) {
+      return false;
+    }
+    const LogLinearHistogram& histogram = *timer.histogram;
+    result.sketch = histogram;
+    result.median = result.quantile(0.5);
+
+    using ns = std::chrono::nanoseconds;
+    const size_t first = histogram.indexOf(timer.streaming.min);
+    const size_t last  = histogram.indexOf(timer.streaming.max);
+    const size_t median_index =
+      histogram.indexOf(PreciseTimeColumn::toNanoseconds(result.median));
+    result.h             = Histogram{};
+    // the last bucket is open ended, it ends at the largest measurement
+    const auto highestAt = [&histogram, &timer](size_t i) {
+      return std::min(histogram.highestAt(i), timer.streaming.max);
+    };
+    result.h.bucket_size = ns(highestAt(median_index) - histogram.lowestAt(median_index) + 1);
+    result.h.buckets.reserve(last - first + 1);
+    for (size_t i = first; i <= last; ++i) {
+      const uint64_t count = histogram.countAt(i);
+      const int num        = static_cast<int>(
+        std::min<uint64_t>(count, static_cast<uint64_t>(std::numeric_limits<int>::max())));
+      result.h.buckets.push_back(
+        typename Histogram::Bucket{ns(histogram.lowestAt(i)), PreciseTime(ns(highestAt(i))) + ns(1), num});
+      result.h.max_num_in_bucket = std::max(result.h.max_num_in_bucket, num);
+    }
+    return true;
+  }
+
+  /*!
+   * @brief The statistics of the measurements in the window: mean and
+   * standard deviation from the running sums, min, max, median, quantiles
+   * and histogram from the measurements themselves, no outliners.
+   */
+  static bool getWindowResult(const std::string& name, Window& window, Result& result) {
+    using ns = std::chrono::nanoseconds;
+    window.dropOlderThan(Clock::stop());
+    result.timer_name          = name;
+    result.number_measurements = window.size;
+    if (result.number_measurements < 3) {
+      return false;
+    }
+    // a copy in the scratch buffer, the ring stays untouched
+    std::vector<int64_t>& values = window.ordered();
+    const auto min_max           = std::minmax_element(values.begin(), values.end());
+    result.mean                  = window.accumulator.mean();
+    result.standard_derivation   = window.accumulator.standardDeviation();
+    result.min_measurement       = ns(*min_max.first);
+    result.max_measurement       = ns(*min_max.second);
+    setFromValues(values, result);
+    return true;
+  }
+
+  /*!
+   * @brief The statistics of a RESERVOIR timer: the exact ones of
+   * STREAMING, median, quantiles and histogram from the sample.
+   */
+  static bool getReservoirResult(const std::string& name, Timer& timer, Result& result) {
+    if (!getStreamingResult(name, timer.streaming, result)) {
+      return false;
+    }
+    std::vector<int64_t>& values = timer.reservoir.scratch;
+    values.assign(timer.reservoir.nanos.begin(), timer.reservoir.nanos.end());
+    setFromValues(values, result);
+    return true;
+  }
+
+  /*!
+   * @brief Sets median, sketch and histogram (over [min_measurement,
+   * max_measurement]) of the Result from the given values, no outliners.
+   * The values are reordered.
+   */
+  static void setFromValues(std::vector<int64_t>& values, Result& result) {
+    const size_t n          = values.size();
+    result.number_outliners = 0;
+    result.is_outliner      = std::vector<bool>(n, false);
+
+    result.sketch.emplace();
+    for (const int64_t value : values) {
+      result.sketch->record(value);
+    }
+
+    const auto bucket_size = result.h.scottsRuleBucketSize(n, result.standard_derivation);
+    result.h.initBuckets(bucket_size, result.min_measurement, result.max_measurement);
+    result.h.fillBuckets(values.data(), n, result.is_outliner, 1);
+
+    result.median = findMedian(values.data(), n);
+  }
+
+  /*!
+   * @brief Returns the names and all timers with measurements, sorted by
+   * name.
+   * @param with_streaming Include the STREAMING and HISTOGRAM timers.
+   */
+  std::vector<std::pair<const std::string*, Timer*>> recordedTimers(bool with_streaming) {
+    std::vector<std::pair<const std::string*, Timer*>> recorded;
+    for (const auto& timer_id : timer_ids) {
+      Timer& timer = timers[timer_id.second];
+      if (timer.hasMeasurements() && (with_streaming || timer.storage == Storage::SAMPLES)) {
+        recorded.emplace_back(&timer_id.first, &timer);
+      }
+    }
+    return recorded;
+  }
+
+  friend class BasicConcurrentCollectingTimer<Clock>;
+  friend class BasicCallTreeTimer<Clock>;
+
+  std::map<std::string, TimerId, std::less<>> timer_ids;
+  std::vector<Timer> timers;
+  Storage default_storage = Storage::SAMPLES;
+  size_t report_threads   = 1;
+  PreciseTime overhead    = PreciseTime::zero();
 };
 
+using CollectingTimer = BasicCollectingTimer<>;
+
 #endif
@@ -0,0 +1,177 @@
+/**
+ * @file compressed_column.hpp
+ * @brief Implements CompressedColumn: nanosecond samples stored as zig-zag
+ * encoded deltas, bit-packed in blocks of 128, so series of similar samples
+ * take one to two bytes per sample instead of eight. Blocks are decoded one
+ * at a time, the reductions never expand the whole column.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef COMPRESSED_COLUMN_H
+#define COMPRESSED_COLUMN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A column of int64_t nanoseconds in blocks of BLOCK_SIZE samples.
+ *
+ * A full block keeps its first sample and the differences of every further
+ * sample to its predecessor. The differences are zig-zag encoded (small
+ * negative ones become small positive ones) and packed with the bit width of
+ * the largest one, e.g. 10 bits if neighbours differ by less than 512ns. The
+ * samples of the last, not yet full block are kept plain, push_back() only
+ * packs every BLOCK_SIZE-th sample. An empty column allocates nothing, so it
+ * costs only its three vectors.
+ *
+ * The blocks are read by block(b, buffer): the reductions of the
+ * CollectingTimer decode one block into a buffer of BUFFER_SIZE values on
+ * the stack and reduce it while it is cached.
+ */
+class CompressedColumn {
+ public:
+  static constexpr size_t BLOCK_SIZE = 128;
+  /// The size of the buffer block() decodes into.
+  static constexpr size_t BUFFER_SIZE = BLOCK_SIZE;
+
+  void push_back(int64_t nanos) {
+    if (tail.capacity() < BLOCK_SIZE) {
+      tail.reserve(BLOCK_SIZE);
+    }
+    tail.push_back(nanos);
+    if (tail.size() == BLOCK_SIZE) {
+      pack();
+    }
+  }
+
+  void clear() noexcept {
+    headers.clear();
+    words.clear();
+    tail.clear();
+  }
+
+  size_t size() const noexcept { return headers.size() * BLOCK_SIZE + tail.size(); }
+  bool empty() const noexcept { return size() == 0; }
+
+  size_t numBlocks() const noexcept { return headers.size() + (tail.empty() ? 0 : 1); }
+
+  /// The number of samples in block b, BLOCK_SIZE for all but the last.
+  size_t blockSize(size_t b) const noexcept { return b < headers.size() ? BLOCK_SIZE : tail.size(); }
+
+  /**
+   * @brief Returns the samples of block b: decoded into buffer or, for the
+   * last block if it is not full, the plain samples.
+   * @param b The block, in [0, numBlocks()).
+   * @param buffer Room for BUFFER_SIZE samples.
+   * @return blockSize(b) samples.
+   */
+  const int64_t* block(size_t b, int64_t* buffer) const noexcept {
+    if (b == headers.size()) {
+      return tail.data();
+    }
+    const Header& header = headers[b];
+    const uint64_t* packed = words.data() + header.word_offset;
+    const unsigned width   = header.width;
+    const uint64_t mask    = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    uint64_t value         = static_cast<uint64_t>(header.first);
+    buffer[0]              = header.first;
+    size_t bit             = 0;
+    for (size_t i = 1; i < BLOCK_SIZE; ++i, bit += width) {
+      const size_t word    = bit / 64;
+      const unsigned shift = bit % 64;
+      uint64_t zigzag      = width == 0 ? 0 : packed[word] >> shift;
+      if (shift + width > 64) {
+        zigzag |= packed[word + 1] << (64 - shift);
+      }
+      zigzag &= mask;
+      // wrapping arithmetic: the deltas of any int64_t samples round trip
+      value    += (zigzag >> 1U) ^ (~(zigzag & 1U) + 1);
+      buffer[i] = static_cast<int64_t>(value);
+    }
+    return buffer;
+  }
+
+  /**
+   * @brief Returns sample i, decodes its block.
+   */
+  int64_t at(size_t i) const noexcept {
+    std::array<int64_t, BUFFER_SIZE> buffer;
+    return block(i / BLOCK_SIZE, buffer.data())[i % BLOCK_SIZE];
+  }
+
+  /**
+   * @brief Returns the bytes the column takes, without the plain last
+   * block.
+   */
+  size_t packedBytes() const noexcept {
+    return headers.size() * sizeof(Header) + words.size() * sizeof(uint64_t);
+  }
+
+ private:
+  struct Header {
+    int64_t first      = 0;
+    size_t word_offset = 0;
+    unsigned width     = 0;
+  };
+
+  /**
+   * @brief Packs the full tail into a block.
+   */
+  void pack() {
+    std::array<uint64_t, BLOCK_SIZE> zigzags{};
+    uint64_t all_bits = 0;
+    for (size_t i = 1; i < BLOCK_SIZE; ++i) {
+      const auto delta = static_cast<int64_t>(static_cast<uint64_t>(tail[i]) - static_cast<uint64_t>(tail[i - 1]));
+      zigzags[i] = (static_cast<uint64_t>(delta) << 1U) ^ static_cast<uint64_t>(delta >> 63);
+      all_bits |= zigzags[i];
+    }
+    Header header;
+    header.first       = tail[0];
+    header.word_offset = words.size();
+    header.width       = bitWidth(all_bits);
+    const unsigned width = header.width;
+    words.resize(words.size() + ((BLOCK_SIZE - 1) * width + 63) / 64);
+    uint64_t* packed = words.data() + header.word_offset;
+    size_t bit       = 0;
+    for (size_t i = 1; i < BLOCK_SIZE && width > 0; ++i, bit += width) {
+      const size_t word    = bit / 64;
+      const unsigned shift = bit % 64;
+      packed[word] |= zigzags[i] << shift;
+      if (shift + width > 64) {
+        packed[word + 1] |= zigzags[i] >> (64 - shift);
+      }
+    }
+    headers.push_back(header);
+    tail.clear();
+  }
+
+  /**
+   * @brief The number of bits needed to represent the value, 0 for 0.
+   */
+  static unsigned bitWidth(uint64_t value) noexcept {
+    if (value == 0) {
+      return 0;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return 64 - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned width = 0;
+    while (value != 0) {
+      value >>= 1U;
+      ++width;
+    }
+    return width;
+#endif
+  }
+
+  std::vector<Header> headers;
+  std::vector<uint64_t> words;
+  /// The plain samples of the last block, reserved on the first push_back().
+  std::vector<int64_t> tail;
+};
+
+#endif
@@ -0,0 +1,412 @@
+/**
+ * @file concurrent_collecting_timer.hpp
+ * @brief Implements a CollectingTimer which can be started and stopped from
+ * many threads at once. Every thread records into its own buffer without
+ * locking, the buffers are merged when the results are requested.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef CONCURRENT_COLLECTING_TIMER_H
+#define CONCURRENT_COLLECTING_TIMER_H
+
+#include "clock.hpp"
+#include "collecting_timer.hpp"
+#include "precise_time_column.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*!
+ * @brief Runs multiple named timers from multiple threads and collects all
+ * their measurements.
+ *
+ * start(TimerId) and stop(TimerId) only touch the buffer of the calling
+ * thread, so they take no lock and never allocate the buffer. A thread has to
+ * call attachThread() (or reserve()) before it records, and again for timers
+ * registered after that, else its measurements are ignored. A measurement has
+ * to be started and stopped by the same thread. getResult(), measurementsToFile(), histogramToFile()
+ * and operator<< first merge all thread buffers into one CollectingTimer,
+ * they must not run while other threads record (e.g. call them after the
+ * workers were joined or between two frames).
+ * @tparam Clock The clock policy, see clock.hpp.
+ */
+template <class Clock = DefaultClock>
+class BasicConcurrentCollectingTimer {
+ public:
+  using time_point = typename Clock::time_point;
+  using Collected  = BasicCollectingTimer<Clock>;
+  using TimerId    = typename Collected::TimerId;
+  using Result     = typename Collected::Result;
+
+  /// Everything a thread writes into is aligned to this, so two threads never share a cache line.
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  BasicConcurrentCollectingTimer() {
+    const std::lock_guard<std::mutex> lock(liveMutex());
+    liveSerials().push_back(serial);
+  }
+  BasicConcurrentCollectingTimer(const BasicConcurrentCollectingTimer&) = delete;
+  BasicConcurrentCollectingTimer& operator=(const BasicConcurrentCollectingTimer&) = delete;
+
+  ~BasicConcurrentCollectingTimer() {
+    const std::lock_guard<std::mutex> lock(liveMutex());
+    auto& live = liveSerials();
+    live.erase(std::remove(live.begin(), live.end(), serial), live.end());
+  }
+
+  /*!
+   * @brief Returns the handle of the timer with the given name, the timer is
+   * created if it does not exist yet. Takes a lock, register the timers
+   * before the threads start recording.
+   * @param name The name under which the measurements shall be saved.
+   * @return The handle, valid for the lifetime of this instance.
+   */
+  TimerId registerTimer(std::string_view name) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    const TimerId id = collected.registerTimer(name);
+    num_timers.store(collected.timers.size(), std::memory_order_release);
+    return id;
+  }
+
+  /*!
+   * @brief Like registerTimer(name), but the collected measurements are kept
+   * in the given Storage, see BasicCollectingTimer::setStorage(). The thread
+   * buffers keep every measurement until they are merged.
+   */
+  TimerId registerTimer(std::string_view name, typename Collected::Storage storage) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    const TimerId id = collected.registerTimer(name, storage);
+    num_timers.store(collected.timers.size(), std::memory_order_release);
+    return id;
+  }
+
+  /*!
+   * @brief Lets the collected timer keep only its last measurements, see
+   * BasicCollectingTimer::setWindow(). The thread buffers keep every
+   * measurement until they are merged, they count as stopped then.
+   */
+  void setWindow(TimerId id,
+                 size_t capacity,
+                 std::chrono::nanoseconds max_age = std::chrono::nanoseconds::zero()) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    collected.setWindow(id, capacity, max_age);
+  }
+
+  /*!
+   * @brief Lets the collected timer keep a uniform random sample of its
+   * measurements, see BasicCollectingTimer::setReservoir().
+   */
+  void setReservoir(TimerId id, size_t capacity) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    collected.setReservoir(id, capacity);
+  }
+
+  /*!
+   * @brief Creates the buffer of the calling thread (or grows it for the
+   * timers registered since). Takes the lock and allocates, call it before
+   * the thread records.
+   */
+  void attachThread() { attach(); }
+
+  /*!
+   * @brief Attaches the calling thread and preallocates the storage for n
+   * measurements of the timer in its buffer, so its next n calls to stop() do
+   * not allocate.
+   * @param id The handle from registerTimer().
+   * @param n The number of measurements.
+   */
+  void reserve(TimerId id, size_t n) {
+    Timer* timer = attach().find(id);
+    if (timer != nullptr) {
+      timer->ticks.reserve(n);
+    }
+  }
+
+  /*!
+   * @brief start starts a new measurement in the calling thread.
+   * @param id The handle from registerTimer().
+   */
+  void start(TimerId id) noexcept {
+    Timer* timer = find(id);
+    if (timer == nullptr) {
+      // TODO debugMsg: The timer was not registered or the thread not attached
+      return;
+    }
+    timer->started = true;
+    timer->start   = Clock::start();
+  }
+
+  /*!
+   * @brief Stops the measurement the calling thread started, computes the
+   * time since start() and saves it in the buffer of the calling thread.
+   * @param id The handle from registerTimer().
+   */
+  void stop(TimerId id) noexcept {
+    const time_point stop = Clock::stop();
+    Timer* timer          = find(id);
+    if (timer == nullptr || !timer->started) {
+      // TODO debugMsg: The timer was never started
+      return;
+    }
+    // stored in ticks, converted when the results are requested
+    timer->ticks.push_back(std::chrono::nanoseconds(Clock::elapsedTicks(timer->start, stop)));
+  }
+
+  /*!
+   * @brief Measures the cost of an empty measurement of this timer type:
+   * start(id) directly followed by stop(id) in the calling thread, on a
+   * scratch instance. Keeps the median as the overhead of the collected
+   * timer, see BasicCollectingTimer::calibrateOverhead().
+   * @param runs The number of empty measurements, at least 3.
+   * @return The overhead.
+   */
+  PreciseTime calibrateOverhead(size_t runs = Collected::DEFAULT_CALIBRATION_RUNS) {
+    BasicConcurrentCollectingTimer scratch;
+    const TimerId id = scratch.registerTimer("overhead");
+    scratch.reserve(id, std::max<size_t>(runs, 3));
+    for (size_t i = 0; i < std::max<size_t>(runs, 3); ++i) {
+      scratch.start(id);
+      scratch.stop(id);
+    }
+    Result distribution;
+    scratch.getResult("overhead", distribution);
+    setOverhead(distribution.median);
+    return distribution.median;
+  }
+
+  void setOverhead(const PreciseTime& measurement_overhead) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    collected.setOverhead(measurement_overhead);
+  }
+
+  /*!
+   * @brief Merges the thread buffers and calculates the statistics of the
+   * given timer, see BasicCollectingTimer::getResult().
+   */
+  bool getResult(const std::string& name, Result& result, bool sort_measurements = true) {
+    return merged().getResult(name, result, sort_measurements);
+  }
+
+  /*!
+   * @brief Merges the thread buffers and calculates exact percentiles of the
+   * given timer, see BasicCollectingTimer::getPercentiles().
+   */
+  bool getPercentiles(const std::string& name,
+                      const std::vector<double>& percents,
+                      std::vector<PreciseTime>& percentiles) {
+    return merged().getPercentiles(name, percents, percentiles);
+  }
+
+  /*!
+   * @brief Merges the thread buffers and calculates the statistics of all
+   * timers, see BasicCollectingTimer::getResults().
+   */
+  std::vector<Result> getResults(bool sort_measurements = true) {
+    return merged().getResults(sort_measurements);
+  }
+
+  /*!
+   * @brief Sets the number of threads the results are calculated on, see
+   * BasicCollectingTimer::setReportThreads().
+   */
+  void setReportThreads(size_t num_threads) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    collected.setReportThreads(num_threads);
+  }
+
+  /*!
+   * @brief Merges the thread buffers and writes all measurements, see
+   * BasicCollectingTimer::measurementsToFile().
+   */
+  template <class T>
+  bool measurementsToFile(const std::string& file_name, char seperator) {
+    return merged().template measurementsToFile<T>(file_name, seperator);
+  }
+
+  /*!
+   * @brief Merges the thread buffers and writes all histograms, see
+   * BasicCollectingTimer::histogramToFile().
+   */
+  template <class T>
+  bool histogramToFile(const std::string& file_name, char seperator) {
+    return merged().template histogramToFile<T>(file_name, seperator);
+  }
+
+  /*!
+   * @brief Merges the thread buffers, calculates for all timers the
+   * statistics and prints them.
+   */
+  friend std::ostream& operator<<(std::ostream& os, BasicConcurrentCollectingTimer& t) {
+    return os << t.merged();
+  }
+
+ private:
+  /*!
+   * @brief A timer as seen by one thread: the start of its running
+   * measurement and its finished ones, in clock ticks.
+   */
+  struct alignas(CACHE_LINE_SIZE) Timer {
+    time_point start{};
+    bool started = false;
+    PreciseTimeColumn ticks;
+  };
+
+  /*!
+   * @brief The timers of one thread. Only the owning thread writes into it.
+   */
+  struct alignas(CACHE_LINE_SIZE) ThreadBuffer {
+    explicit ThreadBuffer(std::thread::id owner_thread) : owner(owner_thread) {}
+
+    std::thread::id owner;
+    std::vector<Timer> timers;
+
+    /// Returns the timer, nullptr if the buffer does not hold it (yet).
+    Timer* find(TimerId id) noexcept { return id < timers.size() ? &timers[id] : nullptr; }
+  };
+
+  /*!
+   * @brief The buffers of the instances the thread is attached to. The
+   * serial is never reused, an entry of a destroyed instance can not match.
+   */
+  struct ThreadCache {
+    struct Entry {
+      uint64_t serial      = 0;
+      ThreadBuffer* buffer = nullptr;
+    };
+    std::vector<Entry> entries;
+    size_t last = 0;
+  };
+
+  static ThreadCache& threadCache() noexcept {
+    thread_local ThreadCache cache;
+    return cache;
+  }
+
+  /*!
+   * @brief Returns the timer in the buffer of the calling thread without
+   * locking or allocating, nullptr if the thread is not attached or the
+   * timer was registered after it attached.
+   */
+  Timer* find(TimerId id) noexcept {
+    ThreadCache& cache = threadCache();
+    if (cache.last < cache.entries.size() && cache.entries[cache.last].serial == serial) {
+      return cache.entries[cache.last].buffer->find(id);
+    }
+    for (size_t i = 0; i < cache.entries.size(); ++i) {
+      if (cache.entries[i].serial == serial) {
+        cache.last = i;
+        return cache.entries[i].buffer->find(id);
+      }
+    }
+    return nullptr;
+  }
+
+  /*!
+   * @brief Returns the buffer of the calling thread and grows it to all
+   * registered timers. The buffers belong to this instance, the measurements
+   * of a finished thread stay until they are merged.
+   *
+   * The first call of a thread drops the cache entries of destroyed instances
+   * (e.g. the scratch of calibrateOverhead()), so the cache of a thread only
+   * holds the instances which are alive.
+   */
+  ThreadBuffer& attach() {
+    ThreadCache& cache   = threadCache();
+    ThreadBuffer* buffer = nullptr;
+    for (const auto& entry : cache.entries) {
+      if (entry.serial == serial) {
+        buffer = entry.buffer;
+      }
+    }
+    if (buffer == nullptr) {
+      {
+        const std::lock_guard<std::mutex> lock(liveMutex());
+        const auto& live = liveSerials();
+        cache.entries.erase(std::remove_if(cache.entries.begin(),
+                                           cache.entries.end(),
+                                           [&live](const typename ThreadCache::Entry& entry) {
+                                             return std::find(live.begin(), live.end(), entry.serial) ==
+                                                    live.end();
+                                           }),
+                            cache.entries.end());
+      }
+      buffer = &ownBuffer();
+      cache.entries.push_back(typename ThreadCache::Entry{serial, buffer});
+    }
+    const size_t num_registered = num_timers.load(std::memory_order_acquire);
+    if (buffer->timers.size() < num_registered) {
+      buffer->timers.resize(num_registered);
+    }
+    return *buffer;
+  }
+
+  /*!
+   * @brief Returns the buffer of the calling thread, creates it if the thread
+   * has none yet. Takes the lock.
+   */
+  ThreadBuffer& ownBuffer() {
+    const std::thread::id thread = std::this_thread::get_id();
+    const std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& buffer : buffers) {
+      // the id of a finished thread may be reused, the buffer is then continued
+      if (buffer->owner == thread) {
+        return *buffer;
+      }
+    }
+    buffers.push_back(std::make_unique<ThreadBuffer>(thread));
+    return *buffers.back();
+  }
+
+  /*!
+   * @brief Moves the measurements of all thread buffers into the collected
+   * timer. The reserved storage of the buffers is kept.
+   */
+  Collected& merged() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& buffer : buffers) {
+      for (size_t id = 0; id < buffer->timers.size(); ++id) {
+        PreciseTimeColumn& ticks = buffer->timers[id].ticks;
+        if (!ticks.empty()) {
+          collected.append(id, ticks);
+          ticks.clear();
+        }
+      }
+    }
+    return collected;
+  }
+
+  /// The serials of all instances which are alive.
+  static std::vector<uint64_t>& liveSerials() noexcept {
+    static std::vector<uint64_t> live;
+    return live;
+  }
+
+  static std::mutex& liveMutex() noexcept {
+    static std::mutex live_mutex;
+    return live_mutex;
+  }
+
+  static uint64_t nextSerial() noexcept {
+    static std::atomic<uint64_t> next_serial{1};
+    return next_serial.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const uint64_t serial = nextSerial();
+  std::atomic<size_t> num_timers{0};
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  Collected collected;
+};
+
+using ConcurrentCollectingTimer = BasicConcurrentCollectingTimer<>;
+
+#endif
@@ -0,0 +1,317 @@
+/**
+ * @file exporter.hpp
+ * @brief Implements Exporter: writes the measurements of CollectingTimers
+ * and the frames of FrameTimers into a file on a background thread, batch by
+ * batch while they are recorded, so the recording threads never touch the
+ * file system.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include "clock.hpp"
+#include "collecting_timer.hpp"
+#include "frame_timer.hpp"
+#include "precise_time_column.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*!
+ * @brief Exports measurements through a bounded queue to a background
+ * thread which writes them into a file.
+ *
+ * push() only copies the new measurements of a timer (or moves the finished
+ * frames out of a FrameTimer) into a batch and queues it. The background
+ * thread wakes up every flush interval, or earlier if the queue is full,
+ * takes all queued batches, formats them and writes them with one write and
+ * one flush. If the queue is full, push() either waits for the writer
+ * (Backpressure::BLOCK) or drops the batch (Backpressure::DROP).
+ *
+ * The file is written as CSV, one measurement per line in nanoseconds:
+ * "frame<sep>timer<sep>ns". Measurements of a CollectingTimer have no frame,
+ * a frame of a FrameTimer is written as the line of "Frame" with its
+ * duration, followed by the accumulated time of every timer which ran in it.
+ *
+ * push() of different timers may be called from different threads, a timer
+ * itself must only be pushed by the thread which records into it.
+ * @tparam Clock The clock policy, see clock.hpp.
+ */
+template <class Clock = DefaultClock>
+class BasicExporter {
+ public:
+  using CollectingTimer = BasicCollectingTimer<Clock>;
+  using FrameTimer      = BasicFrameTimer<Clock>;
+
+  /// What push() does if the queue is full.
+  enum class Backpressure {
+    DROP,  ///< The batch is dropped and counted, see getDropped().
+    BLOCK  ///< push() waits until the writer made room.
+  };
+
+  static constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{100};
+  static constexpr size_t DEFAULT_QUEUE_CAPACITY = 64;
+
+  /*!
+   * @brief Opens the file (overwrites it), writes the header and starts the
+   * background thread.
+   * @param file_name The name of the file. If its a path, the path must exist.
+   * @param seperator_ A character to seperate the fields.
+   * @param flush_interval_ How often the writer wakes up to write the queued
+   * batches.
+   * @param queue_capacity_ The maximal number of queued batches, at least 1.
+   * @param backpressure_ What push() does if the queue is full.
+   */
+  explicit BasicExporter(const std::string& file_name,
+                         char seperator_                            = ';',
+                         std::chrono::milliseconds flush_interval_ = DEFAULT_FLUSH_INTERVAL,
+                         size_t queue_capacity_                     = DEFAULT_QUEUE_CAPACITY,
+                         Backpressure backpressure_                 = Backpressure::BLOCK)
+      : file(file_name.c_str(), std::ios_base::trunc),
+        seperator(seperator_),
+        flush_interval(flush_interval_),
+        queue_capacity(std::max<size_t>(queue_capacity_, 1)),
+        backpressure(backpressure_) {
+    if (!file.is_open()) {
+      return;
+    }
+    file << "frame" << seperator << "timer" << seperator << "measurement ns\n";
+    writer = std::thread(&BasicExporter::run, this);
+  }
+
+  BasicExporter(const BasicExporter&)            = delete;
+  BasicExporter& operator=(const BasicExporter&) = delete;
+
+  /*!
+   * @brief Writes everything pushed so far and stops the background thread.
+   */
+  ~BasicExporter() {
+    if (!writer.joinable()) {
+      return;
+    }
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake_writer.notify_one();
+    writer.join();
+  }
+
+  /// false if the file could not be opened, nothing is exported then.
+  bool isOpen() const noexcept { return writer.joinable(); }
+
+  /*!
+   * @brief Queues the measurements the timer recorded since its last push,
+   * see BasicCollectingTimer::takeNewMeasurements(). Only timers with
+   * Storage::SAMPLES are exported.
+   * @param timer The timer, only the calling thread may record into it.
+   * @param keep If false, the exported measurements are removed from the
+   * timer, so it does not grow.
+   * @return false if nothing was queued: the exporter is not open, there
+   * was nothing new or the batch was dropped.
+   */
+  bool push(CollectingTimer& timer, bool keep = true) {
+    if (!isOpen()) {
+      return false;
+    }
+    Batch batch = spareBatch();
+    const size_t n = timer.takeNewMeasurements(batch.measurements, keep);
+    if (n == 0) {
+      return false;
+    }
+    return enqueue(std::move(batch), n);
+  }
+
+  /*!
+   * @brief Queues the frames the FrameTimer finished since its last push,
+   * see BasicFrameTimer::takeFrameRecords().
+   * @param timer The timer, only the calling thread may record into it.
+   * @return false if nothing was queued: the exporter is not open, no frame
+   * was finished or the batch was dropped.
+   */
+  bool push(FrameTimer& timer) {
+    if (!isOpen()) {
+      return false;
+    }
+    Batch batch  = spareBatch();
+    batch.frames = timer.takeFrameRecords();
+    const size_t n = batch.frames.size();
+    if (n == 0) {
+      return false;
+    }
+    return enqueue(std::move(batch), n);
+  }
+
+  /*!
+   * @brief Waits until everything pushed before is written and flushed to
+   * the file.
+   */
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint64_t target = num_queued;
+    flush_requested       = true;
+    wake_writer.notify_one();
+    written.wait(lock, [this, target]() { return num_written >= target || !isOpen(); });
+  }
+
+  /// The number of measurements and frames dropped because the queue was full.
+  size_t getDropped() const {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return num_dropped;
+  }
+
+ private:
+  /*!
+   * @brief The measurements or the frames of one push.
+   */
+  struct Batch {
+    std::vector<std::pair<std::string, PreciseTimeColumn>> measurements;
+    std::list<typename FrameTimer::FrameRecord> frames;
+  };
+
+  /*!
+   * @brief A batch which was already written, so its memory is reused.
+   */
+  Batch spareBatch() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (spare.empty()) {
+      return Batch{};
+    }
+    Batch batch = std::move(spare.back());
+    spare.pop_back();
+    return batch;
+  }
+
+  bool enqueue(Batch&& batch, size_t n) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (queue.size() >= queue_capacity) {
+      if (backpressure == Backpressure::DROP) {
+        num_dropped += n;
+        return false;
+      }
+      wake_writer.notify_one();
+      has_room.wait(lock, [this]() { return queue.size() < queue_capacity; });
+    }
+    queue.push_back(std::move(batch));
+    ++num_queued;
+    if (queue.size() >= queue_capacity) {
+      wake_writer.notify_one();
+    }
+    return true;
+  }
+
+  /*!
+   * @brief The background thread: every flush interval it takes all queued
+   * batches and writes them outside of the lock.
+   */
+  void run() {
+    std::deque<Batch> writing;
+    std::string text;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wake_writer.wait_for(lock, flush_interval, [this]() {
+        return stopping || flush_requested || queue.size() >= queue_capacity;
+      });
+      const bool stop = stopping;
+      flush_requested = false;
+      writing.swap(queue);
+      lock.unlock();
+      has_room.notify_all();
+
+      for (Batch& batch : writing) {
+        text.clear();
+        format(batch, text);
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+      }
+      file.flush();
+
+      lock.lock();
+      num_written += writing.size();
+      for (Batch& batch : writing) {
+        if (spare.size() < queue_capacity) {
+          batch.frames.clear();
+          spare.push_back(std::move(batch));
+        }
+      }
+      writing.clear();
+      written.notify_all();
+      if (stop && queue.empty()) {
+        return;
+      }
+    }
+  }
+
+  void format(const Batch& batch, std::string& text) {
+    for (const auto& [name, measurements] : batch.measurements) {
+      for (const int64_t nanos : measurements) {
+        text += seperator;
+        text += name;
+        text += seperator;
+        appendNumber(text, nanos);
+        text += '\n';
+      }
+    }
+    for (const auto& [duration, timers] : batch.frames) {
+      appendLine(text, frame_number, "Frame", duration);
+      for (const auto& [name, values] : *timers) {
+        appendLine(text, frame_number, name, values.accumulation);
+      }
+      ++frame_number;
+    }
+  }
+
+  void appendLine(std::string& text, uint64_t frame, std::string_view name, const PreciseTime& time) const {
+    appendNumber(text, frame);
+    text += seperator;
+    text += name;
+    text += seperator;
+    appendNumber(text, PreciseTimeColumn::toNanoseconds(time));
+    text += '\n';
+  }
+
+  template <class Integer>
+  static void appendNumber(std::string& text, Integer value) {
+    char digits[24];
+    const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    text.append(digits, end);
+  }
+
+  std::ofstream file;
+  const char seperator;
+  const std::chrono::milliseconds flush_interval;
+  const size_t queue_capacity;
+  const Backpressure backpressure;
+
+  mutable std::mutex mutex;
+  std::condition_variable wake_writer;
+  std::condition_variable has_room;
+  std::condition_variable written;
+  std::deque<Batch> queue;
+  std::vector<Batch> spare;
+  uint64_t num_queued  = 0;
+  uint64_t num_written = 0;
+  size_t num_dropped   = 0;
+  bool flush_requested = false;
+  bool stopping        = false;
+  uint64_t frame_number = 0;  // only used by the writer
+  std::thread writer;
+};
+
+using Exporter = BasicExporter<>;
+
+#endif
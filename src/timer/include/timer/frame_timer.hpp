@@ -11,18 +11,38 @@
 #ifndef FRAME_TIMER_H
 #define FRAME_TIMER_H
 
+#include "clock.hpp"
 #include "precise_time.hpp"
 #include "scoped_timer.hpp"
+#include <array>
+#include <cstdio>
 #include <fstream>
 #include <iterator>
 #include <list>
 #include <map>
 #include <memory>
 
-class FrameTimer {
+/*!
+ * @brief Accumulates the timings of named ScopedTimers for each frame.
+ * @tparam Clock The clock policy, see clock.hpp.
+ */
+template <class Clock = DefaultClock>
+class BasicFrameTimer {
  public:
-  FrameTimer() {
-    report_back = std::bind(&FrameTimer::reportBack,
+  using time_point  = typename Clock::time_point;
+  using ScopedTimer = BasicScopedTimer<Clock>;
+
+  struct TimedValues {
+    PreciseTime accumulation = PreciseTime::zero();
+    std::vector<std::pair<time_point, PreciseTime>> single_events;
+  };
+  using NamedTimer = std::pair<std::string, TimedValues>;
+  using TimerMap   = std::map<std::string, TimedValues>;
+  /// A finished frame: its duration and the timers which ran in it.
+  using FrameRecord = std::pair<PreciseTime, std::shared_ptr<TimerMap>>;
+
+  BasicFrameTimer() {
+    report_back = std::bind(&BasicFrameTimer::reportBack,
                             this,
                             std::placeholders::_1,
                             std::placeholders::_2,
@@ -35,7 +55,7 @@ class FrameTimer {
   template <bool debug_to_console = false>
   void frameStart() {
     frameStop();
-    frame_start   = PreciseTime::PrecisionClock::now();
+    frame_start   = Clock::start();
     frame_stopped = false;
   }
 
@@ -45,10 +65,9 @@ class FrameTimer {
       return;
     }
     frame_stopped        = true;
-    const auto frame_end = PreciseTime::PrecisionClock::now();
+    const time_point frame_end = Clock::stop();
     if (!current_timers->empty()) {
-      const std::chrono::nanoseconds duration =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(frame_end - frame_start);
+      const PreciseTime duration = Clock::elapsed(frame_start, frame_end);
       frame_records.emplace_back(std::make_pair(duration, std::move(current_timers)));
       current_timers = std::make_shared<TimerMap>();
       if constexpr (debug_to_console) {
@@ -66,6 +85,18 @@ class FrameTimer {
     return ScopedTimer(name, report_back);
   }
 
+  /*!
+   * @brief Moves the finished frames out, e.g. to export them on another
+   * thread (see BasicExporter), so the FrameTimer does not grow. They are no
+   * longer written by measurementsToFile().
+   * @return The frames finished since the last call, oldest first.
+   */
+  std::list<FrameRecord> takeFrameRecords() noexcept {
+    std::list<FrameRecord> taken;
+    taken.swap(frame_records);
+    return taken;
+  }
+
   /*!
    * @brief Writes all measurements from all timers into the given file
    * (appends) for further analysis with Excel or Matlab.
@@ -127,7 +158,7 @@ class FrameTimer {
     // the data
     i = 0;
     for (const auto& m : frame_records) {
-      const double frame_time         = m.first.toDouble<T>();
+      const double frame_time         = m.first.template toDouble<T>();
       const double frame_time_percent = 100. / frame_time;
       input_line                      = std::to_string(frame_time);
       for (const auto& t : timers) {
@@ -136,7 +167,7 @@ class FrameTimer {
           // lol?
           continue;
         }
-        const double function_time = it->second.accumulation.toDouble<T>();
+        const double function_time = it->second.accumulation.template toDouble<T>();
         const double function_percent_frame_time = function_time * frame_time_percent;
         input_line += seperator + std::to_string(function_time) + seperator +
                       std::to_string(function_percent_frame_time);
@@ -154,7 +185,7 @@ class FrameTimer {
    * @param timing The result of the timer.
    */
   void reportBack(const std::string& name,
-                  const PreciseTime::PrecisionClock::time_point& start,
+                  const time_point& start,
                   const PreciseTime& timeing) {
     const auto timer = current_timers->find(name);
     if (timer != current_timers->end()) {
@@ -174,77 +205,84 @@ class FrameTimer {
    */
   void debug2Console() const {
     using ns = std::chrono::nanoseconds;
-    std::pair<std::string, PreciseTime> longest("", PreciseTime::zero());
-    std::pair<std::string, PreciseTime> second_longest = longest;
-    std::pair<std::string, PreciseTime> third_longest  = longest;
+    // names are only referenced and the frame time is formatted on the stack,
+    // so printing every frame does not allocate
+    static const std::string no_name;
+    std::pair<const std::string*, PreciseTime> longest(&no_name, PreciseTime::zero());
+    std::pair<const std::string*, PreciseTime> second_longest = longest;
+    std::pair<const std::string*, PreciseTime> third_longest  = longest;
     const auto last_frame_record = (--frame_records.end());
 
     for (const auto& t : *(last_frame_record->second)) {
       if (t.second.accumulation > longest.second) {
         std::swap(second_longest, third_longest);
         std::swap(longest, second_longest);
-        longest = std::make_pair(t.first, t.second.accumulation);
+        longest = std::make_pair(&t.first, t.second.accumulation);
       } else if (t.second.accumulation > second_longest.second) {
         std::swap(second_longest, third_longest);
-        second_longest = std::make_pair(t.first, t.second.accumulation);
+        second_longest = std::make_pair(&t.first, t.second.accumulation);
       } else if (t.second.accumulation > third_longest.second) {
-        third_longest = std::make_pair(t.first, t.second.accumulation);
+        third_longest = std::make_pair(&t.first, t.second.accumulation);
       }
     }
 
-    const double f = 100. / last_frame_record->first.toDouble<ns>();
+    const double f = 100. / last_frame_record->first.template toDouble<ns>();
     const int p1 = static_cast<int>(std::round(longest.second.toDouble<ns>() * f));
     const int p2 =
       static_cast<int>(std::round(second_longest.second.toDouble<ns>() * f));
     const int p3 = static_cast<int>(std::round(third_longest.second.toDouble<ns>() * f));
 
-    // max name length is 10 characters. See printf %-10s
-    const auto rs = [](std::string& s) {
-      if (s.length() > 10) {
-        s[6] = '\0';  // Sometimes my genius… It's almost frightening.
-      }
-      return s.c_str();
+    // max name length is 10 characters. See printf %-10.*s
+    // names longer than that are cut to 6 characters
+    const auto rl = [](const std::string* s) {
+      return static_cast<int>(s->length() > 10 ? 6 : s->length());
     };
 
+    std::array<char, PreciseTime::MAX_CHARS + 1> frame_time{};
+    const auto frame_time_end = last_frame_record->first.timeStringToChars(
+      frame_time.data(), frame_time.data() + PreciseTime::MAX_CHARS, 2);
+    *frame_time_end.ptr = '\0';
+
     const auto N = (last_frame_record->second)->size();
     if (N == 1) {
-      printf("[%-10s \033[1m%2d%%\033[0m] %s\n",
-             rs(longest.first),
+      printf("[%-10.*s \033[1m%2d%%\033[0m] %s\n",
+             rl(longest.first),
+             longest.first->c_str(),
              p1,
-             last_frame_record->first.getTimeString(2).c_str());
+             frame_time.data());
     } else if (N == 2) {
-      printf("[%-10s \033[1m%2d%%\033[0m || %-10s \033[1m%2d%%\033[0m] %s\n",
-             rs(longest.first),
+      printf("[%-10.*s \033[1m%2d%%\033[0m || %-10.*s \033[1m%2d%%\033[0m] %s\n",
+             rl(longest.first),
+             longest.first->c_str(),
              p1,
-             rs(second_longest.first),
+             rl(second_longest.first),
+             second_longest.first->c_str(),
              p2,
-             last_frame_record->first.getTimeString(2).c_str());
+             frame_time.data());
     } else if (N > 2) {
       printf(
-        "[%-10s \033[1m%2d%%\033[0m || %-10s \033[1m%2d%%\033[0m || %-10s "
+        "[%-10.*s \033[1m%2d%%\033[0m || %-10.*s \033[1m%2d%%\033[0m || %-10.*s "
         "\033[1m%2d%%\033[0m] %s\n",
-        rs(longest.first),
+        rl(longest.first),
+        longest.first->c_str(),
         p1,
-        rs(second_longest.first),
+        rl(second_longest.first),
+        second_longest.first->c_str(),
         p2,
-        rs(third_longest.first),
+        rl(third_longest.first),
+        third_longest.first->c_str(),
         p3,
-        last_frame_record->first.getTimeString(2).c_str());
+        frame_time.data());
     }
   }
 
-  using time_point = PreciseTime::PrecisionClock::time_point;
-  struct TimedValues {
-    PreciseTime accumulation = PreciseTime::zero();
-    std::vector<std::pair<time_point, PreciseTime>> single_events;
-  };
-  using NamedTimer = std::pair<std::string, TimedValues>;
-  using TimerMap   = std::map<std::string, TimedValues>;
   std::shared_ptr<TimerMap> current_timers = std::make_shared<TimerMap>();
-  std::list<std::pair<PreciseTime, std::shared_ptr<TimerMap>>> frame_records;
+  std::list<FrameRecord> frame_records;
   time_point frame_start;
   bool frame_stopped = false;
-  ScopedTimer::reportBack report_back;
+  typename ScopedTimer::reportBack report_back;
 };
 
+using FrameTimer = BasicFrameTimer<>;
+
 #endif
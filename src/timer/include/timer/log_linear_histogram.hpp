@@ -0,0 +1,296 @@
+/**
+ * @file log_linear_histogram.hpp
+ * @brief Implements LogLinearHistogram: a mergeable histogram of nanosecond
+ * samples with buckets which grow with the value (HdrHistogram layout), so
+ * long tailed latencies are recorded in constant time and fixed memory with a
+ * bounded relative error.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef LOG_LINEAR_HISTOGRAM_H
+#define LOG_LINEAR_HISTOGRAM_H
+
+#include "precise_time.hpp"
+#include "precise_time_column.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Counts nanosecond samples in [0, highest_trackable] in log-linear
+ * buckets: every power of two range is split into the same number of linear
+ * sub buckets, enough to tell apart 10^significant_digits values. Every value
+ * within a bucket differs from its lowest value by less than
+ * 10^-significant_digits relative. Negative samples are counted as 0, samples
+ * above the highest trackable value in the last bucket, which is open ended.
+ * min and max stay exact for all samples.
+ *
+ * The counts are allocated once on construction (for 2 significant digits
+ * and the default range of one hour ~4600 counters), record() is a bit scan,
+ * a shift and an increment. Histograms with the same number of significant
+ * digits and the same range can be merged.
+ */
+class LogLinearHistogram {
+ public:
+  static constexpr int DEFAULT_SIGNIFICANT_DIGITS = 2;
+  static constexpr int MAX_SIGNIFICANT_DIGITS     = 5;
+  /// One hour in nanoseconds.
+  static constexpr int64_t DEFAULT_HIGHEST_TRACKABLE = 3'600'000'000'000;
+
+  /**
+   * @brief Constructor.
+   * @param significant_digits The decimal digits which shall be resolved,
+   * clamped to [1, MAX_SIGNIFICANT_DIGITS]. Every digit multiplies the
+   * memory by about 8, over one hour: 5 KB for 1 digit, 36 KB for 2,
+   * 264 KB for 3, 3.6 MB for 4 and 26 MB for 5.
+   * @param highest_trackable The largest sample in nanoseconds which is
+   * resolved with significant_digits, at least 1. The memory grows with its
+   * logarithm.
+   */
+  explicit LogLinearHistogram(int significant_digits = DEFAULT_SIGNIFICANT_DIGITS,
+                              int64_t highest_trackable = DEFAULT_HIGHEST_TRACKABLE)
+      : digits(std::clamp(significant_digits, 1, MAX_SIGNIFICANT_DIGITS)),
+        highest(std::max<int64_t>(highest_trackable, 1)) {
+    uint64_t largest_single_unit = 2;
+    for (int d = 0; d < digits; ++d) {
+      largest_single_unit *= 10;
+    }
+    const int sub_bucket_count_magnitude = bitWidth(largest_single_unit - 1);
+    sub_bucket_half_count_magnitude      = sub_bucket_count_magnitude - 1;
+    sub_bucket_half_count = uint64_t{1} << static_cast<unsigned>(sub_bucket_half_count_magnitude);
+    sub_bucket_mask = (uint64_t{1} << static_cast<unsigned>(sub_bucket_count_magnitude)) - 1;
+    // the first bucket holds [0, sub_bucket_count), every further one doubles
+    // until the highest trackable value is covered
+    int bucket_count              = 1;
+    uint64_t smallest_untrackable = uint64_t{1} << static_cast<unsigned>(sub_bucket_count_magnitude);
+    while (smallest_untrackable <= static_cast<uint64_t>(highest)) {
+      smallest_untrackable <<= 1U;
+      ++bucket_count;
+    }
+    counts.resize(static_cast<size_t>(bucket_count + 1) * static_cast<size_t>(sub_bucket_half_count));
+  }
+
+  /**
+   * @brief Counts one sample: a bit scan, a shift and an increment.
+   * @param nanos The sample in nanoseconds.
+   */
+  void record(int64_t nanos) noexcept {
+    ++counts[indexOf(nanos)];
+    ++total_count;
+    min_value = std::min(min_value, nanos);
+    max_value = std::max(max_value, nanos);
+  }
+
+  void record(const PreciseTime& value) noexcept {
+    record(PreciseTimeColumn::toNanoseconds(value));
+  }
+
+  /**
+   * @brief Adds the counts of another histogram, e.g. of another thread.
+   * @return false if the histograms do not have the same significant digits
+   * and range, nothing is added then.
+   */
+  bool merge(const LogLinearHistogram& other) noexcept {
+    if (other.digits != digits || other.counts.size() != counts.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+      counts[i] += other.counts[i];
+    }
+    total_count += other.total_count;
+    min_value    = std::min(min_value, other.min_value);
+    max_value    = std::max(max_value, other.max_value);
+    return true;
+  }
+
+  /**
+   * @brief Sets all counts to 0, keeps the memory.
+   */
+  void reset() noexcept {
+    std::fill(counts.begin(), counts.end(), 0);
+    total_count = 0;
+    min_value   = std::numeric_limits<int64_t>::max();
+    max_value   = std::numeric_limits<int64_t>::min();
+  }
+
+  int getSignificantDigits() const noexcept { return digits; }
+  int64_t getHighestTrackable() const noexcept { return highest; }
+  uint64_t getTotalCount() const noexcept { return total_count; }
+  /// The exact smallest and largest recorded samples.
+  int64_t getMin() const noexcept { return min_value; }
+  int64_t getMax() const noexcept { return max_value; }
+
+  /// The number of buckets, the valid bucket indexes are [0, numBuckets()).
+  size_t numBuckets() const noexcept { return counts.size(); }
+  uint64_t countAt(size_t index) const noexcept { return counts[index]; }
+
+  /**
+   * @brief Returns the index of the bucket the value is counted in, the
+   * last one for values above its range.
+   */
+  size_t indexOf(int64_t nanos) const noexcept {
+    const uint64_t value     = nanos < 0 ? 0 : static_cast<uint64_t>(nanos);
+    const int bucket_index   = bitWidth(value | sub_bucket_mask) - (sub_bucket_half_count_magnitude + 1);
+    const uint64_t sub_index = value >> static_cast<unsigned>(bucket_index);
+    const uint64_t index =
+      (static_cast<uint64_t>(bucket_index + 1) << static_cast<unsigned>(sub_bucket_half_count_magnitude)) +
+      sub_index - sub_bucket_half_count;
+    return static_cast<size_t>(std::min<uint64_t>(index, counts.size() - 1));
+  }
+
+  /**
+   * @brief Returns the smallest value counted in the bucket.
+   */
+  int64_t lowestAt(size_t index) const noexcept {
+    int bucket_index = static_cast<int>(index >> static_cast<unsigned>(sub_bucket_half_count_magnitude)) - 1;
+    uint64_t sub_index = (index & (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+    if (bucket_index < 0) {
+      sub_index -= sub_bucket_half_count;
+      bucket_index = 0;
+    }
+    return static_cast<int64_t>(sub_index << static_cast<unsigned>(bucket_index));
+  }
+
+  /**
+   * @brief Returns the largest value counted in the bucket, int64_t max for
+   * the last one.
+   */
+  int64_t highestAt(size_t index) const noexcept {
+    if (index + 1 >= counts.size()) {
+      return std::numeric_limits<int64_t>::max();
+    }
+    const int64_t lowest = lowestAt(index);
+    const int64_t width  = int64_t{1} << static_cast<unsigned>(bucketIndexOfIndex(index));
+    return lowest > std::numeric_limits<int64_t>::max() - (width - 1) ?
+             std::numeric_limits<int64_t>::max() :
+             lowest + (width - 1);
+  }
+
+  /**
+   * @brief Returns the value below which the fraction q of the samples lie:
+   * the center of the bucket holding the ceil(q * n)-th smallest sample,
+   * limited to the exact min and max, which are returned for the first and
+   * the last sample.
+   * @param q The quantile in [0, 1].
+   * @return 0 if nothing was recorded.
+   */
+  PreciseTime quantile(double q) const noexcept {
+    if (total_count == 0) {
+      return PreciseTime::zero();
+    }
+    const uint64_t rank = rankOf(q);
+    uint64_t seen       = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+      seen += counts[i];
+      if (seen >= rank) {
+        return valueAt(i, rank);
+      }
+    }
+    return valueAt(counts.size() - 1, rank);
+  }
+
+  /**
+   * @brief Like quantile() for several quantiles, in one pass over the
+   * buckets.
+   * @param qs The quantiles in [0, 1], in any order.
+   * @return The values in the order of qs, all 0 if nothing was recorded.
+   */
+  std::vector<PreciseTime> quantiles(const std::vector<double>& qs) const {
+    std::vector<PreciseTime> values(qs.size(), PreciseTime::zero());
+    if (total_count == 0) {
+      return values;
+    }
+    std::vector<std::pair<uint64_t, size_t>> ranks;
+    ranks.reserve(qs.size());
+    for (size_t i = 0; i < qs.size(); ++i) {
+      ranks.emplace_back(rankOf(qs[i]), i);
+    }
+    std::sort(ranks.begin(), ranks.end());
+    auto rank     = ranks.begin();
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size() && rank != ranks.end(); ++i) {
+      seen += counts[i];
+      for (; rank != ranks.end() && rank->first <= seen; ++rank) {
+        values[rank->second] = valueAt(i, rank->first);
+      }
+    }
+    return values;
+  }
+
+ private:
+  /**
+   * @brief The rank ceil(q * n) of the sample which marks the quantile q,
+   * in [1, n].
+   */
+  uint64_t rankOf(double q) const noexcept {
+    const double rank = std::ceil(std::clamp(q, 0., 1.) * static_cast<double>(total_count));
+    return std::clamp<uint64_t>(static_cast<uint64_t>(rank), 1, total_count);
+  }
+
+  /**
+   * @brief The estimate of the sample of the given rank in the bucket: the
+   * exact min or max for the first or the last rank, the center of the
+   * bucket otherwise.
+   */
+  PreciseTime valueAt(size_t index, uint64_t rank) const noexcept {
+    if (rank == 1) {
+      return std::chrono::nanoseconds(min_value);
+    }
+    if (rank == total_count) {
+      return std::chrono::nanoseconds(max_value);
+    }
+    const int64_t lowest = lowestAt(index);
+    const int64_t center = lowest + (highestAt(index) - lowest) / 2;
+    return std::chrono::nanoseconds(std::clamp(center, min_value, max_value));
+  }
+
+  int bucketIndexOfIndex(size_t index) const noexcept {
+    const int bucket_index = static_cast<int>(index >> static_cast<unsigned>(sub_bucket_half_count_magnitude)) - 1;
+    return std::max(bucket_index, 0);
+  }
+
+  /**
+   * @brief The number of bits needed to represent the value, 0 for 0.
+   */
+  static int bitWidth(uint64_t value) noexcept {
+    if (value == 0) {
+      return 0;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return 64 - __builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index) + 1;
+#else
+    int width = 0;
+    while (value != 0) {
+      value >>= 1U;
+      ++width;
+    }
+    return width;
+#endif
+  }
+
+  int digits;
+  int64_t highest;
+  int sub_bucket_half_count_magnitude = 0;
+  uint64_t sub_bucket_half_count      = 0;
+  uint64_t sub_bucket_mask            = 0;
+  uint64_t total_count                = 0;
+  int64_t min_value = std::numeric_limits<int64_t>::max();
+  int64_t max_value = std::numeric_limits<int64_t>::min();
+  std::vector<uint64_t> counts;
+};
+
+#endif
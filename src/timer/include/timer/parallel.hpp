@@ -0,0 +1,92 @@
+/**
+ * @file parallel.hpp
+ * @brief Implements how the reports of the CollectingTimer run in parallel
+ * if enabled: independent tasks are handed out to a number of threads which
+ * are started per call, the calling thread works along.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef TIMER_PARALLEL_H
+#define TIMER_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+/**
+ * @brief Returns the number of threads to use: num_threads, or the number of
+ * hardware threads if it is 0.
+ */
+inline size_t numThreads(size_t num_threads) noexcept {
+  if (num_threads != 0) {
+    return num_threads;
+  }
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Returns into how many chunks n values shall be split so every
+ * thread gets at least min_per_chunk values, at least 1.
+ */
+inline size_t numChunks(size_t n, size_t num_threads, size_t min_per_chunk) noexcept {
+  return std::max<size_t>(1, std::min(numThreads(num_threads), n / min_per_chunk));
+}
+
+/**
+ * @brief Returns the begin of chunk c of n values split into num_chunks.
+ * Chunk c is [chunkBegin(c), chunkBegin(c + 1)).
+ */
+inline size_t chunkBegin(size_t c, size_t n, size_t num_chunks) noexcept {
+  return c == num_chunks ? n : c * (n / num_chunks);
+}
+
+/**
+ * @brief Calls task(i) for every i in [0, num_tasks) on at most num_threads
+ * threads, the calling thread included. The tasks are handed out in order,
+ * a thread takes the next one when it is done. If no thread can be started,
+ * the calling thread runs all tasks.
+ * @param num_tasks The number of tasks.
+ * @param num_threads The maximal number of threads, 0 for the number of
+ * hardware threads.
+ * @param task Called with the index of the task, must not throw.
+ */
+template <class Task>
+void forEach(size_t num_tasks, size_t num_threads, const Task& task) {
+  const size_t used_threads = std::min(numThreads(num_threads), num_tasks);
+  if (used_threads <= 1) {
+    for (size_t i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  auto work = [&next, num_tasks, &task]() {
+    for (size_t i = next++; i < num_tasks; i = next++) {
+      task(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(used_threads - 1);
+  for (size_t t = 1; t < used_threads; ++t) {
+    try {
+      threads.emplace_back(work);
+    } catch (const std::system_error&) {
+      break;  // no more threads available, the started ones and this one do the work
+    }
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+}  // namespace parallel
+
+#endif
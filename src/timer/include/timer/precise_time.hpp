@@ -1,9 +1,9 @@
 /**
  * @file precise_time.hpp
  * @brief Implements the PreciseTime class useing std::chrono.
- * @date 11.05.2025
+ * @date 16.10.2026
  * @author Jakob Wandel
- * @version 3.0
+ * @version 4.0
  **/
 
 #ifndef PRECISE_TIME_H
@@ -11,12 +11,31 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <ratio>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <array>
+#include <charconv>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__has_include)
+#if __has_include(<format>)
+#include <format>
+#endif
+#endif
+
+#include "wide_int.hpp"
 
 /**
  * @brief Computes the fractional and integral parts of a floating-point number.
@@ -289,130 +308,434 @@ constexpr auto timeunit2String() {
   }
 }
 
-class PreciseTime {
+/**
+ * @brief Describes the largest time span a BasicPreciseTime has to hold:
+ * N times Unit. Like for a std::chrono duration the Unit component may range
+ * over [-N-1, N] and everything finer than one Unit comes on top, so
+ * TimeSpan<INT64_MAX, std::chrono::hours64> is the range of std::chrono::hours64
+ * plus 59m 59s 999ms 999us 999ns.
+ * @tparam N The number of Units.
+ * @tparam Unit The std::chrono::duration type N is given in.
+ */
+template <intmax_t N, class Unit>
+struct TimeSpan {
+  static_assert(N > 0, "The time span has to be positive");
+  static constexpr intmax_t count = N;
+  using unit                      = Unit;
+};
+
+/**
+ * @brief Compile-time storage layout of a BasicPreciseTime: the limits in
+ * ticks of Resolution and the narrowest integers holding them.
+ * For Exponent 1 the count holds ticks, for Exponent > 1 ticks^Exponent and
+ * for Exponent < 1 (ratios and rates) the value times ticks per second.
+ * @tparam Resolution The std::chrono::duration type of one tick.
+ * @tparam MaxSpan A TimeSpan.
+ * @tparam Exponent The power of the time unit: s, s^2, ...
+ */
+template <class Resolution, class MaxSpan, int Exponent>
+struct PreciseTimeStorage {
+  using ticks_per_unit = std::ratio_divide<typename MaxSpan::unit::period, typename Resolution::period>;
+  using ns_per_tick    = std::ratio_divide<typename Resolution::period, std::nano>;
+  static_assert(ticks_per_unit::den == 1, "The unit of MaxSpan has to be a multiple of Resolution");
+  static_assert(ns_per_tick::den == 1, "The resolution can not be finer than nanoseconds");
+
+  static constexpr wide_int::int128 MAX_TICKS =
+    (wide_int::int128(MaxSpan::count) + 1) * wide_int::int128(ticks_per_unit::num) - 1;
+  static constexpr wide_int::int128 MIN_TICKS =
+    -(wide_int::int128(MaxSpan::count) + 2) * wide_int::int128(ticks_per_unit::num) + 1;
+
+  template <class T>
+  static constexpr bool fits(const wide_int::int128& max, const wide_int::int128& min) noexcept {
+    return max <= wide_int::int128(wide_int::limits<T>::max()) &&
+           min >= wide_int::int128(wide_int::limits<T>::min());
+  }
+
+  /// MAX_TICKS^Exponent, saturated at the 128 bit limit
+  static constexpr wide_int::int128 maxPower() noexcept {
+    wide_int::int128 power = MAX_TICKS;
+    for (int i = 1; i < Exponent; ++i) {
+      if (!wide_int::checkedMul(power, MAX_TICKS, power)) {
+        return wide_int::limits<wide_int::int128>::max();
+      }
+    }
+    return power;
+  }
+
+  template <class T>
+  using narrowest = typename std::conditional<
+    fits<int32_t>(T::max, T::min),
+    int32_t,
+    typename std::conditional<fits<int64_t>(T::max, T::min), int64_t, wide_int::int128>::type>::type;
+
+  struct TickRange {
+    static constexpr wide_int::int128 max = MAX_TICKS;
+    static constexpr wide_int::int128 min = MIN_TICKS;
+  };
+  struct PowerRange {
+    static constexpr wide_int::int128 max = maxPower();
+    static constexpr wide_int::int128 min = -maxPower();
+  };
+  struct NanoRange {
+    static constexpr wide_int::int128 max = MAX_TICKS * wide_int::int128(ns_per_tick::num);
+    static constexpr wide_int::int128 min = MIN_TICKS * wide_int::int128(ns_per_tick::num);
+  };
+
+  /// the count of ticks for Exponent 1
+  using tick_rep = narrowest<TickRange>;
+
+  /// the count: ticks for Exponent 1, wide enough for MAX_TICKS^Exponent above
+  /// and at least 64 bit below
+  using rep = typename std::conditional<
+    (Exponent == 1),
+    tick_rep,
+    typename std::conditional<(Exponent > 1),
+                              narrowest<PowerRange>,
+                              typename std::conditional<std::is_same<tick_rep, int32_t>::value,
+                                                        int64_t,
+                                                        tick_rep>::type>::type>::type;
+
+  /// holds the whole range in nanoseconds and the count, used for all unit conversions
+  using calc = typename std::conditional<std::is_same<narrowest<NanoRange>, wide_int::int128>::value ||
+                                           std::is_same<rep, wide_int::int128>::value,
+                                         wide_int::int128,
+                                         int64_t>::type;
+};
+
+/**
+ * @brief Appends text and numbers to a caller provided char buffer without
+ * allocating. Used by the to_chars style functions of BasicPreciseTime.
+ */
+class CharWriter {
+ public:
+  /**
+   * @brief Writes into [first, last).
+   * @param first The begin of the buffer.
+   * @param last The end of the buffer.
+   */
+  CharWriter(char* first, char* last) noexcept : pos(first), end(last) {}
+
+  CharWriter& operator<<(const char* text) noexcept {
+    for (; *text != '\0'; ++text) {
+      if (pos == end) {
+        return fail();
+      }
+      *pos++ = *text;
+    }
+    return *this;
+  }
+
+  CharWriter& operator<<(int64_t value) noexcept {
+    const auto result = std::to_chars(pos, end, value);
+    if (result.ec != std::errc()) {
+      return fail();
+    }
+    pos = result.ptr;
+    return *this;
+  }
+
+  /**
+   * @brief Writes value with a fixed number of decimal places, like
+   * std::fixed << std::setprecision(precision). A negative precision means 6.
+   */
+  CharWriter& fixed(double value, int precision) noexcept {
+    constexpr int DEFAULT_PRECISION = 6;
+    const auto result = std::to_chars(
+      pos, end, value, std::chars_format::fixed, precision < 0 ? DEFAULT_PRECISION : precision);
+    if (result.ec != std::errc()) {
+      return fail();
+    }
+    pos = result.ptr;
+    return *this;
+  }
+
+  /**
+   * @brief Returns the end of the written characters, like std::to_chars.
+   */
+  std::to_chars_result result() const noexcept {
+    return {pos, ok ? std::errc() : std::errc::value_too_large};
+  }
+
+ private:
+  CharWriter& fail() noexcept {
+    ok  = false;
+    pos = end;
+    return *this;
+  }
+
+  char* pos;
+  char* end;
+  bool ok = true;
+};
+
+/**
+ * @brief Reads text and numbers from a char range without allocating. Used
+ * by the from_chars style functions of BasicPreciseTime. Every read either
+ * consumes the matched characters and returns true or consumes nothing.
+ */
+class CharReader {
+ public:
+  /**
+   * @brief Reads from [first, last).
+   * @param first The begin of the input.
+   * @param last The end of the input.
+   */
+  CharReader(const char* first, const char* last) noexcept : pos(first), end(last) {}
+
+  /**
+   * @brief Skips spaces and tabs.
+   */
+  CharReader& skipBlanks() noexcept {
+    while (pos != end && (*pos == ' ' || *pos == '\t')) {
+      ++pos;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Consumes text if the input continues with it.
+   */
+  bool consume(const char* text) noexcept {
+    const char* p = pos;
+    for (; *text != '\0'; ++text, ++p) {
+      if (p == end || *p != *text) {
+        return false;
+      }
+    }
+    pos = p;
+    return true;
+  }
+
+  bool readInteger(int64_t& value) noexcept {
+    const auto result = std::from_chars(pos, end, value);
+    if (result.ec != std::errc()) {
+      return false;
+    }
+    pos = result.ptr;
+    return true;
+  }
+
+  /**
+   * @brief Reads a decimal number "[-]digits[.digits][(e|E)[+|-]digits]"
+   * exactly as digits * 10^exponent, no rounding through double. Only the
+   * first 18 significant digits are kept.
+   */
+  bool readDecimal(int64_t& digits, int& exponent) noexcept {
+    constexpr int MAX_DIGITS   = 18;
+    constexpr int MAX_EXPONENT = 100000;
+    const auto isDigit = [](char ch) { return static_cast<unsigned>(ch - '0') < 10U; };
+
+    const char* p       = pos;
+    const bool negative = p != end && *p == '-';
+    if (negative) {
+      ++p;
+    }
+    int64_t mantissa = 0;
+    int num_digits   = 0;
+    int exp          = 0;
+    bool any_digit   = false;
+    const auto addDigit = [&](char ch, bool fraction) {
+      any_digit = true;
+      if (num_digits < MAX_DIGITS) {
+        mantissa = mantissa * 10 + (ch - '0');
+        // leading zeros are not significant
+        num_digits += mantissa != 0 ? 1 : 0;
+        exp        -= fraction ? 1 : 0;
+      } else if (!fraction) {
+        ++exp;
+      }
+    };
+    for (; p != end && isDigit(*p); ++p) {
+      addDigit(*p, false);
+    }
+    if (p != end && *p == '.') {
+      for (++p; p != end && isDigit(*p); ++p) {
+        addDigit(*p, true);
+      }
+    }
+    if (!any_digit) {
+      return false;
+    }
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+      const char* e      = p + 1;
+      const bool neg_exp = e != end && *e == '-';
+      if (e != end && (*e == '-' || *e == '+')) {
+        ++e;
+      }
+      if (e != end && isDigit(*e)) {
+        int value = 0;
+        for (; e != end && isDigit(*e); ++e) {
+          value = std::min(value * 10 + (*e - '0'), MAX_EXPONENT);
+        }
+        exp += neg_exp ? -value : value;
+        p    = e;
+      }
+    }
+
+    digits   = negative ? -mantissa : mantissa;
+    exponent = exp;
+    pos      = p;
+    return true;
+  }
+
+  /**
+   * @brief Returns the position behind the consumed characters.
+   */
+  const char* position() const noexcept { return pos; }
+
+ private:
+  const char* pos;
+  const char* end;
+};
+
+/**
+ * @brief A time (or a power of a time: s, s^2, ...) stored as one signed
+ * integer counting ticks of Resolution^Exponent. Addition, subtraction and
+ * comparison are single integer operations. All arithmetic saturates at
+ * min()/max() instead of rolling over.
+ * The count uses the narrowest integer (int32_t, int64_t or wide_int::int128)
+ * covering MaxSpan at the given Resolution, and the overflow checks which can
+ * not trigger for that layout are removed at compile time. E.g.
+ * BasicPreciseTime<std::chrono::microseconds, TimeSpan<10, std::chrono::minutes>>
+ * is a 4 byte type whose sums of two values never need an overflow check.
+ * The unit is part of the type: multiplying two times adds the exponents,
+ * sqrt() halves it and mixing different units does not compile.
+ * @tparam Resolution The std::chrono::duration type of one tick
+ * (nanoseconds or coarser).
+ * @tparam MaxSpan The TimeSpan which has to be representable.
+ * @tparam Exponent The power of the time unit: 1 for s, 2 for s^2, ...
+ */
+template <class Resolution = std::chrono::nanoseconds,
+          class MaxSpan    = TimeSpan<std::numeric_limits<int64_t>::max(), std::chrono::hours64>,
+          int Exponent     = 1>
+class BasicPreciseTime {
+  using Storage = PreciseTimeStorage<Resolution, MaxSpan, Exponent>;
+
+  template <class, class, int>
+  friend class BasicPreciseTime;
+
  public:
   typedef std::conditional<std::chrono::high_resolution_clock::is_steady,
                            std::chrono::high_resolution_clock,
                            std::chrono::steady_clock>::type PrecisionClock;
 
+  using rep        = typename Storage::rep;
+  using resolution = Resolution;
+  using max_span   = MaxSpan;
+
+  /// The same time type with another exponent.
+  template <int EXPO>
+  using WithExponent = BasicPreciseTime<Resolution, MaxSpan, EXPO>;
+
+ private:
+  using Rep  = rep;
+  using Calc = typename Storage::calc;
+
+  template <int EXPO>
+  using IfTime = typename std::enable_if<EXPO == 1, int>::type;
+
+ public:
   /**
    * @brief Default constructor for PreciseTime.
    */
-  constexpr PreciseTime() = default;
+  constexpr BasicPreciseTime() = default;
 
   /**
    * @brief Constructs a PreciseTime object from nanoseconds.
-   * @param ns Time in nanoseconds.
+   * @param nanos Time in nanoseconds.
    */
-  constexpr PreciseTime(const std::chrono::nanoseconds& ns) noexcept
-      : nano_seconds(ns) {
-    sanitize();
-  }
+  template <int EXPO = Exponent, IfTime<EXPO> = 0>
+  constexpr BasicPreciseTime(const std::chrono::nanoseconds& nanos) noexcept
+      : count(fromDuration<std::nano>(nanos.count())) {}
 
   /**
    * @brief Constructs a PreciseTime object from microseconds.
-   * @param us Time in microseconds.
+   * @param micros Time in microseconds.
    */
-  constexpr PreciseTime(const std::chrono::microseconds& us) noexcept
-      : nano_seconds(std::chrono::nanoseconds(us2ns(us.count()))) {
-    sanitize();
-  }
+  template <int EXPO = Exponent, IfTime<EXPO> = 0>
+  constexpr BasicPreciseTime(const std::chrono::microseconds& micros) noexcept
+      : count(fromDuration<std::micro>(micros.count())) {}
 
   /**
    * @brief Constructs a PreciseTime object from milliseconds.
-   * @param ms Time in milliseconds.
+   * @param millis Time in milliseconds.
    */
-  constexpr PreciseTime(const std::chrono::milliseconds& ms) noexcept
-      : nano_seconds(std::chrono::nanoseconds(ms2ns(ms.count()))) {
-    sanitize();
-  }
+  template <int EXPO = Exponent, IfTime<EXPO> = 0>
+  constexpr BasicPreciseTime(const std::chrono::milliseconds& millis) noexcept
+      : count(fromDuration<std::milli>(millis.count())) {}
 
   /**
    * @brief Constructs a PreciseTime object from seconds.
-   * @param s Time in seconds.
+   * @param secs Time in seconds.
    */
-  constexpr PreciseTime(const std::chrono::seconds& s) noexcept
-      : seconds(s) {
-    sanitize();
-  }
+  template <int EXPO = Exponent, IfTime<EXPO> = 0>
+  constexpr BasicPreciseTime(const std::chrono::seconds& secs) noexcept
+      : count(fromDuration<std::ratio<1>>(secs.count())) {}
 
   /**
    * @brief Constructs a PreciseTime object from minutes.
-   * @param m Time in minutes.
+   * @param mins Time in minutes.
    */
-  constexpr PreciseTime(const std::chrono::minutes& m) noexcept
-      : seconds(std::chrono::seconds(m2s(m.count()))) {
-    sanitize();
-  }
+  template <int EXPO = Exponent, IfTime<EXPO> = 0>
+  constexpr BasicPreciseTime(const std::chrono::minutes& mins) noexcept
+      : count(fromDuration<std::ratio<60>>(mins.count())) {}
 
   /**
    * @brief Constructs a PreciseTime object from hours.
-   * @param h Time in hours.
+   * @param hrs Time in hours.
    */
-  constexpr PreciseTime(const std::chrono::hours64& h)
-      : hours(h) {}
+  template <int EXPO = Exponent, IfTime<EXPO> = 0>
+  constexpr BasicPreciseTime(const std::chrono::hours64& hrs) noexcept
+      : count(fromDuration<std::ratio<3600>>(hrs.count())) {}
 
-  constexpr PreciseTime(const PreciseTime& other) noexcept = default;
+  constexpr BasicPreciseTime(const BasicPreciseTime& other) noexcept = default;
 
   /**
    * @brief Move constructor for PreciseTime.
    * @param other The other PreciseTime object to move.
    */
-  constexpr PreciseTime(PreciseTime&& other) noexcept = default;
+  constexpr BasicPreciseTime(BasicPreciseTime&& other) noexcept = default;
 
   /**
    * @brief Copy assignment operator for PreciseTime.
    * @param other The other PreciseTime object to copy.
    * @return Reference to the current object.
    */
-  PreciseTime& operator=(const PreciseTime& other) noexcept = default;
+  constexpr BasicPreciseTime& operator=(const BasicPreciseTime& other) noexcept = default;
 
   /**
    * @brief Move assignment operator for PreciseTime.
    * @param other The other PreciseTime object to move.
    * @return Reference to the current object.
    */
-  PreciseTime& operator=(PreciseTime&& other) noexcept = default;
+  constexpr BasicPreciseTime& operator=(BasicPreciseTime&& other) noexcept = default;
 
   /**
    * @brief Returns the greatest time the PreciseTime class can hold.
-   * @tparam EXPO The exponent of the time unit.
    * @return The maximum PreciseTime object.
    */
-  template <int EXPO = 1>
-  static constexpr PreciseTime max() noexcept {
-    PreciseTime ps(std::chrono::hours64::max());
-    ps.seconds      = MAX_VALIDE_S;
-    ps.nano_seconds = MAX_VALIDE_NS;
-    ps.exponent     = EXPO;
+  static constexpr BasicPreciseTime max() noexcept {
+    BasicPreciseTime ps;
+    ps.count = MAX_COUNT;
     return ps;
   }
 
   /**
    * @brief Returns the smallest time the PreciseTime class can hold.
-   * @tparam EXPO The exponent of the time unit.
    * @return The minimum PreciseTime object.
    */
-  template <int EXPO = 1>
-  static constexpr PreciseTime min() noexcept {
-    PreciseTime ps(std::chrono::hours64::min());
-    ps.seconds      = MIN_VALIDE_S;
-    ps.nano_seconds = MIN_VALIDE_NS;
-    ps.exponent     = EXPO;
+  static constexpr BasicPreciseTime min() noexcept {
+    BasicPreciseTime ps;
+    ps.count = MIN_COUNT;
     return ps;
   }
 
   /**
    * @brief Returns a PreciseTime object representing zero.
-   * @tparam EXPO The exponent of the time unit.
    * @return A PreciseTime object with zero value.
    */
-  template <int EXPO = 1>
-  static constexpr PreciseTime zero() noexcept {
-    PreciseTime ps;
-    ps.exponent = EXPO;
-    return ps;
-  }
+  static constexpr BasicPreciseTime zero() noexcept { return BasicPreciseTime(); }
 
   /**
    * @brief Converts the PreciseTime to a double value in the specified unit.
@@ -423,9 +746,7 @@ class PreciseTime {
   constexpr
     typename std::enable_if<std::is_same<c, std::chrono::nanoseconds>::value, double>::type
     toDouble() const noexcept {
-    return h2ns(static_cast<double>(hours.count())) +
-           s2ns(static_cast<double>(seconds.count())) +
-           static_cast<double>(nano_seconds.count()) + sub_nano_seconds;
+    return nanoUnitsDouble();
   }
 
   /**
@@ -437,9 +758,7 @@ class PreciseTime {
   constexpr
     typename std::enable_if<std::is_same<c, std::chrono::microseconds>::value, double>::type
     toDouble() const noexcept {
-    return h2us(static_cast<double>(hours.count())) +
-           s2us(static_cast<double>(seconds.count())) +
-           ns2us(static_cast<double>(nano_seconds.count()) + sub_nano_seconds);
+    return ns2us(nanoUnitsDouble());
   }
 
   /**
@@ -451,9 +770,7 @@ class PreciseTime {
   constexpr
     typename std::enable_if<std::is_same<c, std::chrono::milliseconds>::value, double>::type
     toDouble() const noexcept {
-    return h2ms(static_cast<double>(hours.count())) +
-           s2ms(static_cast<double>(seconds.count())) +
-           ns2ms(static_cast<double>(nano_seconds.count()) + sub_nano_seconds);
+    return ns2ms(nanoUnitsDouble());
   }
 
   /**
@@ -463,9 +780,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::seconds>::value, double>::type toDouble() const noexcept {
-    return h2s(static_cast<double>(hours.count())) +
-           static_cast<double>(seconds.count()) +
-           ns2s(static_cast<double>(nano_seconds.count()) + sub_nano_seconds);
+    return ns2s(nanoUnitsDouble());
   }
 
   /**
@@ -475,9 +790,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::minutes>::value, double>::type toDouble() const noexcept {
-    return h2m(static_cast<double>(hours.count())) +
-           s2m(static_cast<double>(seconds.count())) +
-           ns2m(static_cast<double>(nano_seconds.count()) + sub_nano_seconds);
+    return ns2m(nanoUnitsDouble());
   }
 
   /**
@@ -487,9 +800,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::hours64>::value, double>::type toDouble() const noexcept {
-    return static_cast<double>(hours.count()) +
-           s2h(static_cast<double>(seconds.count())) +
-           ns2h(static_cast<double>(nano_seconds.count()) + sub_nano_seconds);
+    return ns2h(nanoUnitsDouble());
   }
 
   /**
@@ -499,8 +810,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::nanoseconds>::value, c>::type convert() const noexcept {
-    return std::chrono::nanoseconds(h2ns(hours.count()) + s2ns(seconds.count()) +
-                                    nano_seconds.count());
+    return std::chrono::nanoseconds(static_cast<int64_t>(nanoUnits()));
   }
 
   /**
@@ -510,8 +820,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::microseconds>::value, c>::type convert() const noexcept {
-    return std::chrono::microseconds(h2us(hours.count()) + s2us(seconds.count()) +
-                                     ns2us(nano_seconds.count()));
+    return std::chrono::microseconds(static_cast<int64_t>(nanoUnits() / NS_PER_US));
   }
 
   /**
@@ -521,8 +830,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::milliseconds>::value, c>::type convert() const noexcept {
-    return std::chrono::milliseconds(h2ms(hours.count()) + s2ms(seconds.count()) +
-                                     ns2ms(nano_seconds.count()));
+    return std::chrono::milliseconds(static_cast<int64_t>(nanoUnits() / NS_PER_MS));
   }
 
   /**
@@ -532,7 +840,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::seconds>::value, c>::type convert() const noexcept {
-    return std::chrono::seconds(h2s(hours.count())) + seconds;
+    return std::chrono::seconds(static_cast<int64_t>(nanoUnits() / NS_PER_S));
   }
 
   /**
@@ -542,8 +850,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::minutes>::value, c>::type convert() const noexcept {
-    return std::chrono::minutes(s2m(seconds.count() + h2m(hours.count())));
-    ;
+    return std::chrono::minutes(static_cast<int64_t>(nanoUnits() / NS_PER_M));
   }
 
   /**
@@ -553,7 +860,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::hours64>::value, c>::type convert() const noexcept {
-    return hours;
+    return std::chrono::hours64(static_cast<int64_t>(nanoUnits() / NS_PER_H));
   }
 
   /**
@@ -563,8 +870,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::nanoseconds>::value, c>::type get() const noexcept {
-    const int64_t ns = nano_seconds.count();
-    return std::chrono::nanoseconds(ns - (ns / 1000) * 1000);
+    return std::chrono::nanoseconds(static_cast<int64_t>(nanoUnits() % NS_PER_US));
   }
 
   /**
@@ -574,8 +880,8 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::microseconds>::value, c>::type get() const noexcept {
-    const int64_t us = nano_seconds.count() / 1000;
-    return std::chrono::microseconds(us - (us / 1000) * 1000);
+    return std::chrono::microseconds(
+      static_cast<int64_t>((nanoUnits() / NS_PER_US) % Calc(1000)));
   }
 
   /**
@@ -585,8 +891,8 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::milliseconds>::value, c>::type get() const noexcept {
-    const int64_t ms = nano_seconds.count() / 1000000;
-    return std::chrono::milliseconds(ms - (ms / 1000) * 1000);
+    return std::chrono::milliseconds(
+      static_cast<int64_t>((nanoUnits() / NS_PER_MS) % Calc(1000)));
   }
 
   /**
@@ -596,8 +902,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::seconds>::value, c>::type get() const noexcept {
-    const int64_t s = seconds.count();
-    return std::chrono::seconds(s - (s / 60) * 60);
+    return std::chrono::seconds(static_cast<int64_t>((nanoUnits() / NS_PER_S) % Calc(60)));
   }
 
   /**
@@ -607,8 +912,7 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::minutes>::value, c>::type get() const noexcept {
-    const int64_t m = seconds.count() / 60;
-    return std::chrono::minutes(m - (m / 60) * 60);
+    return std::chrono::minutes(static_cast<int64_t>((nanoUnits() / NS_PER_M) % Calc(60)));
   }
 
   /**
@@ -618,267 +922,283 @@ class PreciseTime {
    */
   template <class c>
   constexpr typename std::enable_if<std::is_same<c, std::chrono::hours64>::value, c>::type get() const noexcept {
-    return hours;
+    return std::chrono::hours64(static_cast<int64_t>(nanoUnits() / NS_PER_H));
   }
 
   /**
    * @brief Sets the time in nanoseconds.
-   * @param ns Time in nanoseconds.
+   * @param nanos Time in nanoseconds.
    */
-  constexpr void setNanoseconds(double ns) noexcept {
-    constexpr double max_int64_t =
-      static_cast<double>(std::numeric_limits<int64_t>::max());
-    constexpr double min_int64_t =
-      static_cast<double>(std::numeric_limits<int64_t>::min());
-
-    if (ns > max_int64_t || ns < min_int64_t) {
-      setSeconds(ns2s(ns));
-      return;
-    }
-
-    const int64_t ns_  = static_cast<int64_t>(ns);
-    nano_seconds       = std::chrono::nanoseconds(ns_);
-    sub_nano_seconds  += ns - static_cast<double>(ns_);
-    sanitizeNS();
-    sanitizeS();
-  }
+  constexpr void setNanoseconds(double nanos) noexcept { count = countFromNanoUnits(nanos); }
 
   /**
    * @brief Sets the time in seconds.
-   * @param s Time in seconds.
+   * @param secs Time in seconds.
    */
-  constexpr void setSeconds(double s) noexcept {
-    constexpr double max_int64_t =
-      static_cast<double>(std::numeric_limits<int64_t>::max());
-    constexpr double min_int64_t =
-      static_cast<double>(std::numeric_limits<int64_t>::min());
-
-    if (s > max_int64_t || s < min_int64_t) {
-      setHours(s2h(s));
-      return;
-    }
-    const int64_t sec_l = static_cast<int64_t>(s);
-    seconds             = std::chrono::seconds(sec_l);
-    sanitizeS();
-    setNanoseconds(s2ns(s - static_cast<double>(sec_l)));
-  }
+  constexpr void setSeconds(double secs) noexcept { setNanoseconds(s2ns(secs)); }
 
   /**
    * @brief Sets the time in hours.
-   * @param h Time in hours.
-   */
-  constexpr void setHours(double h) noexcept {
-    constexpr double max_int64_t =
-      static_cast<double>(std::numeric_limits<int64_t>::max());
-    constexpr double min_int64_t =
-      static_cast<double>(std::numeric_limits<int64_t>::min());
-
-    if (h > max_int64_t) {
-      const auto exp = exponent;
-      *this          = PreciseTime::max();
-      exponent       = exp;
-      return;
-    } else if (h < min_int64_t) {
-      const auto exp = exponent;
-      *this          = PreciseTime::min();
-      exponent       = exp;
-      return;
-    }
-
-    const int64_t hours_l = static_cast<int64_t>(h);
-    hours                 = std::chrono::hours64(hours_l);
-    setNanoseconds(h2ns(h - static_cast<double>(hours_l)));
-  }
+   * @param hrs Time in hours.
+   */
+  constexpr void setHours(double hrs) noexcept { setNanoseconds(h2ns(hrs)); }
 
   /**
    * @brief Returns the exponent of the PreciseTime.
    * @return The exponent.
    */
-  constexpr int getExponent() const noexcept { return exponent; }
+  static constexpr int getExponent() noexcept { return Exponent; }
 
   /**
-   * @brief Sets the exponent of the PreciseTime.
-   * @param exp The exponent to set.
+   * @brief Returns the raw internal count (see PreciseTimeStorage).
+   * @return The count.
    */
-  constexpr void setExponent(int exp) noexcept { this->exponent = exp; }
+  constexpr Rep getCount() const noexcept { return count; }
+
+  /**
+   * @brief Creates a PreciseTime from a raw internal count (see getCount()),
+   * saturating at min()/max().
+   * @param value The count.
+   * @return The PreciseTime.
+   */
+  static constexpr BasicPreciseTime fromCount(const Rep& value) noexcept {
+    BasicPreciseTime pt;
+    pt.count = clamp(value);
+    return pt;
+  }
 
  private:
+  static constexpr Calc NS_PER_US = Calc(us2ns(int64_t{1}));
+  static constexpr Calc NS_PER_MS = Calc(ms2ns(int64_t{1}));
+  static constexpr Calc NS_PER_S  = Calc(s2ns(int64_t{1}));
+  static constexpr Calc NS_PER_M  = Calc(s2ns(m2s(int64_t{1})));
+  static constexpr Calc NS_PER_H  = Calc(h2ns(int64_t{1}));
+
+  static constexpr Calc NS_PER_TICK = Calc(Storage::ns_per_tick::num);
+  static constexpr Calc TICKS_PER_S = NS_PER_S / NS_PER_TICK;
+
+  // the limits of the count: a time span for exponent 1, symmetric otherwise
+  static constexpr Rep MAX_COUNT =
+    Exponent == 1 ? Rep(Storage::MAX_TICKS) : wide_int::limits<Rep>::max();
+  static constexpr Rep MIN_COUNT =
+    Exponent == 1 ? Rep(Storage::MIN_TICKS) : -wide_int::limits<Rep>::max();
+
+  // the limits in nanoseconds, all exponents print at most these values
+  static constexpr Calc MAX_NANO = Calc(Storage::MAX_TICKS) * NS_PER_TICK;
+  static constexpr Calc MIN_NANO = Calc(Storage::MIN_TICKS) * NS_PER_TICK;
+
+  // no clamping needed if the limits are the limits of Rep
+  static constexpr bool NEEDS_CLAMP =
+    MAX_COUNT != wide_int::limits<Rep>::max() || MIN_COUNT != wide_int::limits<Rep>::min();
+
+  // no overflow check needed if the sum of two valid counts fits into Rep
+  static constexpr bool SUM_FITS_REP =
+    wide_int::int128(MAX_COUNT) <= wide_int::int128(wide_int::limits<Rep>::max()) / 2 &&
+    wide_int::int128(MIN_COUNT) >= wide_int::int128(wide_int::limits<Rep>::min()) / 2;
+
   /**
-   * @brief If the internal counter for the nano seconds get over
-   * 999999999 we adjust the nanoseconds by adding to the internal seconds.
-   */
-  constexpr void sanitizeNS() noexcept {
-    if (nano_seconds > MAX_VALIDE_NS || nano_seconds < MIN_VALIDE_NS) {
-      double seconds_from_nanoseconds = static_cast<double>(ns2s(nano_seconds.count()));
-      double carry_seconds = 0;
-      fastModF(seconds_from_nanoseconds, carry_seconds);
-      const int64_t carry_seconds_l = static_cast<int64_t>(carry_seconds);
-
-      // substract the nanoseconds which made up a second
-      nano_seconds =
-        std::chrono::nanoseconds(nano_seconds.count() - s2ns(carry_seconds_l));
-      // add them to the seconds
-      seconds += std::chrono::seconds(carry_seconds_l);
+   * @brief Clamps a count into [MIN_COUNT, MAX_COUNT].
+   */
+  static constexpr Rep clamp(const Rep& value) noexcept {
+    if constexpr (NEEDS_CLAMP) {
+      if (value > MAX_COUNT) {
+        return MAX_COUNT;
+      }
+      if (value < MIN_COUNT) {
+        return MIN_COUNT;
+      }
     }
+    return value;
   }
 
   /**
-   * @brief Adjusts the sub-nanoseconds to ensure they are within valid range.
+   * @brief Clamps a value of a type at least as wide as Rep into
+   * [MIN_COUNT, MAX_COUNT].
    */
-  constexpr void sanitizeSubNs() noexcept {
-    const double ns = static_cast<double>(static_cast<int64_t>(sub_nano_seconds));
-    nano_seconds     += std::chrono::nanoseconds(static_cast<int64_t>(ns));
-    sub_nano_seconds -= ns;
+  template <class T>
+  static constexpr Rep clampFrom(const T& value) noexcept {
+    if (value > T(MAX_COUNT)) {
+      return MAX_COUNT;
+    }
+    if (value < T(MIN_COUNT)) {
+      return MIN_COUNT;
+    }
+    return Rep(value);
   }
 
   /**
-   * @brief If the internal counter for the seconds 3599
-   * we adjust the seconds by adding to the internal hours.
+   * @brief Converts a count of a std::chrono::duration with the given period
+   * into ticks (truncating), saturating at the limits.
    */
-  constexpr void sanitizeS() noexcept {
-    /// Sanitize seconds
-    if (seconds > MAX_VALIDE_S || seconds < MIN_VALIDE_S) {
-      double hours_from_seconds = static_cast<double>(s2h(seconds.count()));
-      double carry_hours        = 0;
-      fastModF(hours_from_seconds, carry_hours);
-
-      const int64_t carry_hours_l = static_cast<int64_t>(carry_hours);
-      // substract the seconds which made up a hour
-
-      const bool was_positive  = isPositive();
-      const bool expect_higher = carry_hours_l > 0;
-
-      seconds = std::chrono::seconds(seconds.count() - h2s(carry_hours_l));
-      // add them to the hours
-      hours += std::chrono::hours64(carry_hours_l);
-      overflowProtection(was_positive, expect_higher);
+  template <class Period>
+  static constexpr Rep fromDuration(int64_t value) noexcept {
+    using ticks = std::ratio_divide<Period, typename Resolution::period>;
+    Calc result = Calc(value);
+    if constexpr (ticks::num != 1) {
+      if (!wide_int::checkedMul(result, Calc(ticks::num), result)) {
+        return value < 0 ? MIN_COUNT : MAX_COUNT;
+      }
+    }
+    if constexpr (ticks::den != 1) {
+      result /= Calc(ticks::den);
     }
+    return clampFrom(result);
   }
 
   /**
-   * @brief Sometimes when substracting we end up with different
-   * signs: {10s} - {10ns} will lead to a internal value of {+10s and -10ns}. We
-   * have to adjust this to {9s and 999999990ns}.
-   * This assumes all values (hours, seconds, nanoseconds to be in a sane range
+   * @brief Converts a value given in "nano units" (the value in s^Exponent
+   * times 10^9, which is what the components print) into the count.
    */
-  constexpr void sanitizeSign() noexcept {
+  static constexpr Rep countFromNanoUnits(double nano_units) noexcept {
+    double scaled = nano_units / wide_int::toDouble(NS_PER_TICK);
+    for (int i = 1; i < Exponent; ++i) {
+      scaled *= wide_int::toDouble(TICKS_PER_S);
+    }
+    return clamp(wide_int::fromDouble<Rep>(scaled));
+  }
 
-    auto sameSign = [](int64_t a, int64_t b) {
-      if (a == 0 || b == 0) {
-        return true;
+  /**
+   * @brief Returns the value in "nano units": the value in s^Exponent times
+   * 10^9. For exponent 1 this is the time in nanoseconds. Saturated values
+   * stay saturated across units.
+   */
+  constexpr Calc nanoUnits() const noexcept {
+    if constexpr (Exponent == 1) {
+      return Calc(count) * NS_PER_TICK;
+    } else {
+      if (hasRolledOver()) {
+        return count > Rep(0) ? MAX_NANO : MIN_NANO;
       }
-      const bool s_a = a > 0 ? true : false;
-      const bool s_b = b > 0 ? true : false;
-      return s_a == s_b;
-    };
-
-    // fix s if it has a different sign to h
-    if (!sameSign(seconds.count(), hours.count())) {
-      if (hours.count() < 0) {
-        hours   += std::chrono::hours64(1);
-        seconds  = seconds - std::chrono::seconds(3600);
-      } else {
-        hours   -= std::chrono::hours64(1);
-        seconds  = std::chrono::seconds(3600) + seconds;
+      Calc result = Calc(count);
+      for (int i = 1; i < Exponent; ++i) {
+        // ticks^2 * ns_per_tick / 10^9 == ticks, keep the precision if possible
+        if (wide_int::checkedMul(result, NS_PER_TICK, result)) {
+          result /= NS_PER_S;
+        } else {
+          result /= TICKS_PER_S;
+        }
+      }
+      if (!wide_int::checkedMul(result, NS_PER_TICK, result)) {
+        return count < Rep(0) ? MIN_NANO : MAX_NANO;
       }
+      return result > MAX_NANO ? MAX_NANO : (result < MIN_NANO ? MIN_NANO : result);
     }
+  }
 
-    // fix ns if it now has different sign to s
-    if (!sameSign(nano_seconds.count(), seconds.count())) {
-      if (seconds.count() < 0) {
-        seconds      += std::chrono::seconds(1);
-        nano_seconds  = nano_seconds - std::chrono::nanoseconds(1000000000);
-      } else {
-        seconds      -= std::chrono::seconds(1);
-        nano_seconds  = std::chrono::nanoseconds(1000000000) + nano_seconds;
-      }
-    } else if (!sameSign(nano_seconds.count(), hours.count())) {
-      if (hours.count() < 0) {
-        hours        += std::chrono::hours64(1);
-        seconds       = std::chrono::seconds(-3600 + 1);
-        nano_seconds  = nano_seconds - std::chrono::nanoseconds(1000000000);
-      } else {
-        hours        -= std::chrono::hours64(1);
-        seconds       = std::chrono::seconds(3600 - 1);
-        nano_seconds  = std::chrono::nanoseconds(1000000000) + nano_seconds;
-      }
+  /**
+   * @brief Floating point version of nanoUnits().
+   */
+  constexpr double nanoUnitsDouble() const noexcept {
+    if (Exponent == 1 || hasRolledOver()) {
+      return wide_int::toDouble(nanoUnits());
     }
+    double result = wide_int::toDouble(count);
+    for (int i = 1; i < Exponent; ++i) {
+      result /= wide_int::toDouble(TICKS_PER_S);
+    }
+    return result * wide_int::toDouble(NS_PER_TICK);
   }
 
   /**
-   * @brief Combines all sanitize functions.
+   * @brief Multiplies the count with value, saturating at the limits.
    */
-  constexpr void sanitize() noexcept {
-    sanitizeSubNs();
-    sanitizeNS();
-    sanitizeS();
-    sanitizeSign();
+  constexpr void multiplyCount(const Rep& value) noexcept {
+    Rep product{};
+    if (!wide_int::checkedMul(count, value, product)) {
+      product = (count < Rep(0)) != (value < Rep(0)) ? MIN_COUNT : MAX_COUNT;
+    }
+    count = clamp(product);
   }
 
   /**
-   * @brief Checks if a operation (+-* /) did cause an over
-   * or underflow. If it happened THIS is set to max() or min();
-   * @param was_positive_before_operation Set to true if this was positive
-   * before the operation.
-   * @param expected_higher Set to True if you expect this (time) to be higher
-   * than before the operation.
+   * @brief Returns true if d is a whole number which fits into Rep and int64_t.
    */
-  constexpr void overflowProtection(bool was_positive_before_operation,
-                                    bool expected_higher) noexcept {
-    if (was_positive_before_operation) {
-      if (expected_higher) {
-        if (!isPositive()) {
-          *this           = max();
-          has_rolled_over = true;
-        }
-      }
-    } else {
-      if (!expected_higher) {
-        if (isPositive()) {
-          *this           = min();
-          has_rolled_over = true;
-        }
+  static constexpr bool isWholeRep(double d) noexcept {
+    constexpr double LIMIT =
+      wide_int::limits<Rep>::digits < 63 ? wide_int::toDouble(wide_int::limits<Rep>::max()) : 9.2e18;
+    return d <= LIMIT && d >= -LIMIT && d == static_cast<double>(static_cast<int64_t>(d));
+  }
+
+  /**
+   * @brief Integer square root, rounded down. Newton's method starting above
+   * the root.
+   */
+  static constexpr Rep isqrt(const Rep& n) noexcept {
+    if (n <= Rep(0)) {
+      return Rep(0);
+    }
+    Rep root = Rep(1);
+    for (Rep rest = n; rest >= Rep(4); rest /= Rep(4)) {
+      root *= Rep(2);
+    }
+    root *= Rep(2);
+    while (true) {
+      const Rep next = (root + n / root) / Rep(2);
+      if (next >= root) {
+        return root;
       }
+      root = next;
     }
   }
 
   /**
-   * @brief Checks for overflow or underflow based on the given hours value.
-   * @param hours_d The hours value to check.
-   * @return True if overflow or underflow occurred, false otherwise.
+   * @brief The power of TICKS_PER_S a count of the given exponent is scaled
+   * with (see PreciseTimeStorage).
    */
-  constexpr bool overflowProtection(double hours_d) noexcept {
-    const auto type = overflowProtectionType(hours_d);
+  static constexpr int scalePower(int exp) noexcept { return exp >= 1 ? exp : 1; }
 
-    if (type == 1) {
-      *this           = max();
-      has_rolled_over = true;
-      return true;
+  /**
+   * @brief Computes numerator * TICKS_PER_S^power / denominator exactly
+   * (truncating) in 128 bit.
+   * @return false if an intermediate result overflows or denominator is 0.
+   */
+  static constexpr bool scaledQuotient(wide_int::int128 numerator,
+                                       wide_int::int128 denominator,
+                                       int power,
+                                       wide_int::int128& quotient) noexcept {
+    const auto ticks_per_s = wide_int::int128(TICKS_PER_S);
+    for (int i = 0; i < power; ++i) {
+      if (!wide_int::checkedMul(numerator, ticks_per_s, numerator)) {
+        return false;
+      }
     }
-    if (type == -1) {
-      *this           = min();
-      has_rolled_over = true;
-      return true;
+    for (int i = power; i < 0; ++i) {
+      if (!wide_int::checkedMul(denominator, ticks_per_s, denominator)) {
+        return false;
+      }
+    }
+    if (denominator == wide_int::int128(0)) {
+      return false;
     }
-    return false;
+    quotient = numerator / denominator;
+    return true;
   }
 
   /**
-   * @brief Determines the type of overflow or underflow based on the given hours value.
-   * @param hours_d The hours value to check.
-   * @return 1 for overflow, -1 for underflow, 0 for no overflow or underflow.
+   * @brief Multiplies the count with mantissa / 2^shift exactly (truncating).
+   * @return false if the product does not fit into 128 bit.
    */
-  constexpr int overflowProtectionType(double hours_d) noexcept {
-    constexpr double max_h = static_cast<double>(std::chrono::hours64::max().count());
-    constexpr double min_h = static_cast<double>(std::chrono::hours64::min().count());
-
-    if (hours_d > max_h) {
-      return 1;
+  constexpr bool multiplyDyadic(int64_t mantissa, int shift) noexcept {
+    wide_int::int128 product{};
+    if (!wide_int::checkedMul(wide_int::int128(count), wide_int::int128(mantissa), product)) {
+      return false;
     }
-    if (hours_d < min_h) {
-      return -1;
+    count = clampFrom(wide_int::divPow2(product, shift));
+    return true;
+  }
+
+  /**
+   * @brief Divides the count by mantissa / 2^shift exactly (truncating).
+   * @return false if the intermediate does not fit into 128 bit.
+   */
+  constexpr bool divideDyadic(int64_t mantissa, int shift) noexcept {
+    wide_int::int128 scaled{};
+    if (mantissa == 0 ||
+        !wide_int::checkedMul(wide_int::int128(count), wide_int::pow2<wide_int::int128>(shift), scaled)) {
+      return false;
     }
-    return 0;
+    count = clampFrom(scaled / wide_int::int128(mantissa));
+    return true;
   }
 
  public:
@@ -886,68 +1206,31 @@ class PreciseTime {
    * @brief Checks if the PreciseTime is positive.
    * @return True if positive, false otherwise.
    */
-  constexpr bool isPositive() noexcept {
-    if (hours.count() != 0) {
-      return 0 < hours.count();
-    }
-    if (seconds.count() != 0) {
-      return 0 < seconds.count();
-    }
-    if (nano_seconds.count() != 0) {
-      return 0 < nano_seconds.count();
-    }
-    return sub_nano_seconds >= 0.;
-  }
+  constexpr bool isPositive() const noexcept { return count >= Rep(0); }
 
   /**
    * @brief Checks if the given PreciseTime is positive.
    * @param pt The PreciseTime object to check.
    * @return True if positive, false otherwise.
    */
-  constexpr bool isPositive(const PreciseTime& pt) noexcept {
-    if (pt.hours.count() != 0) {
-      return 0 < pt.hours.count();
-    }
-    if (pt.seconds.count() != 0) {
-      return 0 < pt.seconds.count();
-    }
-    if (pt.nano_seconds.count() != 0) {
-      return 0 < pt.nano_seconds.count();
-    }
-    return pt.sub_nano_seconds >= 0.;
+  constexpr bool isPositive(const BasicPreciseTime& pt) const noexcept {
+    return pt.isPositive();
   }
 
   /**
    * @brief Adds another PreciseTime to the current object.
    * @param pt The other PreciseTime object to add.
    */
-  constexpr void operator+=(const PreciseTime& pt) noexcept {
-    assert(pt.exponent == exponent &&
-           "You can not add different units like s + s^2");
-    if (has_rolled_over) {
-      return;
-    }
-    if (pt.has_rolled_over) {
-      *this = pt;
-      return;
-    }
-
-    const double hours_d =
-      static_cast<double>(hours.count()) + static_cast<double>(pt.hours.count());
-    if (overflowProtection(hours_d)) {
-      return;
+  constexpr void operator+=(const BasicPreciseTime& pt) noexcept {
+    if constexpr (SUM_FITS_REP) {
+      count = clamp(count + pt.count);
+    } else {
+      Rep sum{};
+      if (!wide_int::checkedAdd(count, pt.count, sum)) {
+        sum = pt.count > Rep(0) ? MAX_COUNT : MIN_COUNT;
+      }
+      count = clamp(sum);
     }
-
-    const bool was_positive  = isPositive();
-    const bool expect_higher = isPositive(pt);
-
-    sub_nano_seconds += pt.sub_nano_seconds;
-    nano_seconds     += pt.nano_seconds;
-    seconds          += pt.seconds;
-    hours            += pt.hours;
-
-    sanitize();
-    overflowProtection(was_positive, expect_higher);
   }
 
   /**
@@ -955,8 +1238,8 @@ class PreciseTime {
    * @param pt The other PreciseTime object to add.
    * @return The resulting PreciseTime object.
    */
-  constexpr PreciseTime operator+(const PreciseTime& pt) const noexcept {
-    PreciseTime ret(*this);
+  constexpr BasicPreciseTime operator+(const BasicPreciseTime& pt) const noexcept {
+    BasicPreciseTime ret(*this);
     ret += pt;
     return ret;
   }
@@ -965,33 +1248,16 @@ class PreciseTime {
    * @brief Subtracts another PreciseTime from the current object.
    * @param pt The other PreciseTime object to subtract.
    */
-  constexpr void operator-=(const PreciseTime& pt) noexcept {
-    assert(pt.exponent == exponent &&
-           "You can not substartc different units like s - s^2");
-    if (has_rolled_over) {
-      return;
-    }
-    if (pt.has_rolled_over) {
-      *this = pt;
-      return;
-    }
-
-    const double hours_d =
-      static_cast<double>(hours.count()) - static_cast<double>(pt.hours.count());
-    if (overflowProtection(hours_d)) {
-      return;
+  constexpr void operator-=(const BasicPreciseTime& pt) noexcept {
+    if constexpr (SUM_FITS_REP) {
+      count = clamp(count - pt.count);
+    } else {
+      Rep difference{};
+      if (!wide_int::checkedSub(count, pt.count, difference)) {
+        difference = pt.count < Rep(0) ? MAX_COUNT : MIN_COUNT;
+      }
+      count = clamp(difference);
     }
-
-    const bool was_positive  = isPositive();
-    const bool expect_higher = !isPositive(pt);
-
-    sub_nano_seconds -= pt.sub_nano_seconds;
-    nano_seconds     -= pt.nano_seconds;
-    seconds          -= pt.seconds;
-    hours            -= pt.hours;
-
-    sanitize();
-    overflowProtection(was_positive, expect_higher);
   }
 
   /**
@@ -999,43 +1265,29 @@ class PreciseTime {
    * @param pt The other PreciseTime object to subtract.
    * @return The resulting PreciseTime object.
    */
-  constexpr PreciseTime operator-(const PreciseTime& pt) const noexcept {
-    PreciseTime ret(*this);
+  constexpr BasicPreciseTime operator-(const BasicPreciseTime& pt) const noexcept {
+    BasicPreciseTime ret(*this);
     ret -= pt;
     return ret;
   }
 
   /**
-   * @brief Multiplies the current PreciseTime by a scalar.
+   * @brief Multiplies the current PreciseTime by a scalar. The double is
+   * split exactly into mantissa / 2^shift, so the product is exact (truncating)
+   * as long as it fits into 128 bit.
    * @param multi The scalar multiplier.
    */
   constexpr void operator*=(const double multi) noexcept {
-    if (has_rolled_over) {
+    if (isWholeRep(multi)) {
+      multiplyCount(Rep(static_cast<int64_t>(multi)));
       return;
     }
-    const double hours_ = static_cast<double>(hours.count()) * multi;
-
-    if (overflowProtection(hours_)) {
+    int64_t mantissa = 0;
+    int shift        = 0;
+    if (wide_int::toDyadic(multi, mantissa, shift) && multiplyDyadic(mantissa, shift)) {
       return;
     }
-
-    const double seconds_ = static_cast<double>(seconds.count()) * multi;
-
-    const double nanoseconds_ =
-      static_cast<double>(nano_seconds.count()) * multi + sub_nano_seconds * multi;
-
-    PreciseTime ns;
-    ns.setNanoseconds(nanoseconds_);
-
-    PreciseTime s;
-    s.setSeconds(seconds_);
-
-    PreciseTime h;
-    h.setHours(hours_);
-
-    const auto exp = exponent;
-    *this          = ns + s + h;
-    exponent       = exp;
+    count = clamp(wide_int::fromDouble<Rep>(wide_int::toDouble(count) * multi));
   }
 
   /**
@@ -1043,42 +1295,43 @@ class PreciseTime {
    * @param multi The scalar multiplier.
    * @return The resulting PreciseTime object.
    */
-  constexpr PreciseTime operator*(const double multi) const noexcept {
-    PreciseTime ret(*this);
+  constexpr BasicPreciseTime operator*(const double multi) const noexcept {
+    BasicPreciseTime ret(*this);
     ret *= multi;
     return ret;
   }
 
   /**
-   * @brief Multiplies the current PreciseTime by another PreciseTime.
+   * @brief Multiplies the current PreciseTime by another PreciseTime. The
+   * exponents add up: s * s = s^2.
    * @param pt The other PreciseTime object to multiply.
    * @return The resulting PreciseTime object.
    */
-  constexpr PreciseTime operator*(const PreciseTime& pt) const noexcept {
-    if (has_rolled_over) {
-      return *this;
-    }
-    if (pt.has_rolled_over) {
-      return pt;
-    }
-
-    const double resulting_s =
-      pt.toDouble<std::chrono::seconds>() * toDouble<std::chrono::seconds>();
-
-    const double hours_d = s2h(resulting_s);
-    PreciseTime ret;
-    const auto type = ret.overflowProtectionType(hours_d);
-    if (type == 1) {
-      ret                 = max();
-      ret.has_rolled_over = true;
-    } else if (type == -1) {
-      ret                 = min();
-      ret.has_rolled_over = true;
+  template <int EXPO>
+  constexpr WithExponent<Exponent + EXPO> operator*(const WithExponent<EXPO>& pt) const noexcept {
+    using Result = WithExponent<Exponent + EXPO>;
+    Result ret;
+    const bool negative = (count < Rep(0)) != (pt.count < typename WithExponent<EXPO>::rep(0));
+    if constexpr (Exponent >= 1 && EXPO >= 1) {
+      // ticks^a * ticks^b = ticks^(a+b), the result type is wide enough for both
+      using ResultRep = typename Result::rep;
+      ResultRep product{};
+      if (!wide_int::checkedMul(ResultRep(count), ResultRep(pt.count), product)) {
+        product = negative ? Result::MIN_COUNT : Result::MAX_COUNT;
+      }
+      ret.count = Result::clamp(product);
+    } else {
+      constexpr int POWER =
+        scalePower(Exponent + EXPO) - scalePower(Exponent) - scalePower(EXPO);
+      wide_int::int128 product{};
+      wide_int::int128 quotient{};
+      if (!wide_int::checkedMul(wide_int::int128(count), wide_int::int128(pt.count), product) ||
+          !scaledQuotient(product, wide_int::int128(1), POWER, quotient)) {
+        quotient = negative ? wide_int::limits<wide_int::int128>::min()
+                            : wide_int::limits<wide_int::int128>::max();
+      }
+      ret.count = Result::clampFrom(quotient);
     }
-
-    const double ns = s2ns(resulting_s);
-    ret.setNanoseconds(ns);
-    ret.exponent = exponent + pt.exponent;
     return ret;
   }
 
@@ -1087,51 +1340,50 @@ class PreciseTime {
    * @param div The scalar divisor.
    * @return The resulting PreciseTime object.
    */
-  constexpr PreciseTime operator/(const double div) const noexcept {
-    PreciseTime ret(*this);
-    ret *= (1. / div);
+  constexpr BasicPreciseTime operator/(const double div) const noexcept {
+    BasicPreciseTime ret(*this);
+    ret /= div;
     return ret;
   }
 
   /**
-   * @brief Divides the current PreciseTime by a scalar.
+   * @brief Divides the current PreciseTime by a scalar. Whole numbers divide
+   * exact (truncating), everything else goes through double.
    * @param div The scalar divisor.
    */
-  constexpr void operator/=(const double div) {
-    (*this) *= (1.0 / div);  // this is not as precise
-    return;
+  constexpr void operator/=(const double div) noexcept {
+    if (isWholeRep(div) && div != 0.) {
+      count = clamp(count / Rep(static_cast<int64_t>(div)));
+      return;
+    }
+    int64_t mantissa = 0;
+    int shift        = 0;
+    if (wide_int::toDyadic(div, mantissa, shift) && divideDyadic(mantissa, shift)) {
+      return;
+    }
+    (*this) *= (1.0 / div);
   }
 
   /**
-   * @brief Divides the current PreciseTime by another PreciseTime.
+   * @brief Divides the current PreciseTime by another PreciseTime. The
+   * exponents subtract: s / s = s^0. Exact (truncating) in 128 bit, only
+   * falls back to double if an intermediate overflows.
    * @param pt The other PreciseTime object to divide.
    * @return The resulting PreciseTime object.
    */
-  constexpr PreciseTime operator/(const PreciseTime& pt) const noexcept {
-    if (has_rolled_over) {
-      return *this;
-    }
-    if (pt.has_rolled_over) {
-      return pt;
-    }
-
-    const double resulting_s =
-      pt.toDouble<std::chrono::seconds>() / toDouble<std::chrono::seconds>();
-
-    const double hours_d = s2h(resulting_s);
-    PreciseTime ret;
-    const auto type = ret.overflowProtectionType(hours_d);
-    if (type == 1) {
-      ret                 = max();
-      ret.has_rolled_over = true;
-    } else if (type == -1) {
-      ret                 = min();
-      ret.has_rolled_over = true;
+  template <int EXPO>
+  constexpr WithExponent<Exponent - EXPO> operator/(const WithExponent<EXPO>& pt) const noexcept {
+    using Result = WithExponent<Exponent - EXPO>;
+    // count * S(EXPO) * S(result) / (S(Exponent) * pt.count) with S(e) = TICKS_PER_S^scalePower(e)
+    constexpr int POWER =
+      scalePower(EXPO) + scalePower(Exponent - EXPO) - scalePower(Exponent);
+    Result ret;
+    wide_int::int128 quotient{};
+    if (scaledQuotient(wide_int::int128(count), wide_int::int128(pt.count), POWER, quotient)) {
+      ret.count = Result::clampFrom(quotient);
+    } else {
+      ret.setSeconds(toDouble<std::chrono::seconds>() / pt.template toDouble<std::chrono::seconds>());
     }
-
-    const double ns = s2ns(resulting_s);
-    ret.setNanoseconds(ns);
-    ret.exponent = exponent - pt.exponent;
     return ret;
   }
 
@@ -1140,96 +1392,72 @@ class PreciseTime {
    * @return An array containing time components: nanoseconds, microseconds, milliseconds, seconds, minutes, hours.
    */
   constexpr std::array<int64_t, 6> getSeperatedTimeComponents() const noexcept {
-    return {get<std::chrono::nanoseconds>().count(),
-            get<std::chrono::microseconds>().count(),
-            get<std::chrono::milliseconds>().count(),
-            get<std::chrono::seconds>().count(),
-            get<std::chrono::minutes>().count(),
-            get<std::chrono::hours64>().count()};
+    const Calc nano_units = nanoUnits();
+    return {static_cast<int64_t>(nano_units % NS_PER_US),
+            static_cast<int64_t>((nano_units / NS_PER_US) % Calc(1000)),
+            static_cast<int64_t>((nano_units / NS_PER_MS) % Calc(1000)),
+            static_cast<int64_t>((nano_units / NS_PER_S) % Calc(60)),
+            static_cast<int64_t>((nano_units / NS_PER_M) % Calc(60)),
+            static_cast<int64_t>(nano_units / NS_PER_H)};
   }
 
   /**
-   * @brief Checks if the PreciseTime has rolled over due to overflow or underflow.
-   * @return True if rolled over, false otherwise.
+   * @brief Checks if the PreciseTime is saturated at min() or max() due to an
+   * overflow or underflow.
+   * @return True if saturated, false otherwise.
    */
-  constexpr bool hasRolledOver() { return has_rolled_over; }
+  constexpr bool hasRolledOver() const noexcept {
+    return count >= MAX_COUNT || count <= MIN_COUNT;
+  }
 
   /**
-   * @brief Computes the square root of the given PreciseTime.
+   * @brief Computes the square root of the given PreciseTime: s^2 -> s.
    * @param pt The PreciseTime object to compute the square root of.
    * @return The square root of the given PreciseTime.
    */
-  static PreciseTime sqrt(PreciseTime& pt) noexcept {
-    assert(pt.exponent % 2 == 0 &&
-           "squareroot of Precise time with odd exponent not supported.");
-
-    const double ns = s2ns(std::sqrt(pt.toDouble<std::chrono::seconds>()));
-    const int exp   = pt.exponent;
-    pt              = zero();
-    pt.setNanoseconds(ns);
-    pt.sanitize();
-
-    pt.exponent = exp / 2;
-
-    return pt;
+  static constexpr WithExponent<Exponent / 2> sqrt(const BasicPreciseTime& pt) noexcept {
+    static_assert(Exponent % 2 == 0,
+                  "squareroot of Precise time with odd exponent not supported.");
+    using Result = WithExponent<Exponent / 2>;
+    Result ret;
+    if constexpr (Exponent >= 2) {
+      // the root of ticks^(2n) is ticks^n, Rep is at least as wide as the result
+      ret.count = Result::clampFrom(isqrt(pt.count));
+    } else {
+      ret.setNanoseconds(s2ns(std::sqrt(pt.template toDouble<std::chrono::seconds>())));
+    }
+    return ret;
   }
 
-  /**
-   * @brief Computes the square root of the current PreciseTime.
-   */
-  void sqrt() noexcept { PreciseTime::sqrt(*this); }
-
   /**
    * @brief Returns a new PreciseTime object representing the square root of the current object.
    * @return The square root of the current PreciseTime.
    */
-  PreciseTime getSqrt() const noexcept {
-    PreciseTime ret = *this;
-    PreciseTime::sqrt(ret);
-    return ret;
+  constexpr WithExponent<Exponent / 2> getSqrt() const noexcept {
+    return BasicPreciseTime::sqrt(*this);
   }
 
-  constexpr bool operator==(const PreciseTime& pt) const noexcept {
-    return pt.exponent == exponent && pt.nano_seconds == nano_seconds &&
-           pt.seconds == seconds && pt.hours == hours;
+  constexpr bool operator==(const BasicPreciseTime& pt) const noexcept {
+    return pt.count == count;
   }
 
-  constexpr bool operator!=(const PreciseTime& pt) const noexcept {
+  constexpr bool operator!=(const BasicPreciseTime& pt) const noexcept {
     return !(*this == pt);
   }
 
-  constexpr bool operator<(const PreciseTime& pt) const noexcept {
-    /*
-    bool HE = hours == pt.hours;
-    bool SE = seconds == pt.seconds;
-    bool NSE = nano_seconds == pt.nano_seconds;
-
-    if (HE && SE && NSE) {
-      return false;
-    }
-    if (HE && SE) {
-      return nano_seconds < pt.nano_seconds;
-    }
-    if (HE) {
-      return seconds < pt.seconds;
-    }
-    return hours < pt.hours;
-    */
-    return (hours == pt.hours && seconds == pt.seconds &&
-            nano_seconds != pt.nano_seconds && nano_seconds < pt.nano_seconds) ||
-           (hours == pt.hours && seconds != pt.seconds && seconds < pt.seconds) ||
-           (hours != pt.hours && hours < pt.hours);
+  constexpr bool operator<(const BasicPreciseTime& pt) const noexcept {
+    return count < pt.count;
   }
 
-  constexpr bool operator>(const PreciseTime& pt) const noexcept {
-    return !(*this < pt) && *this != pt;
+  constexpr bool operator>(const BasicPreciseTime& pt) const noexcept {
+    return pt < *this;
   }
 
-  constexpr bool operator<=(const PreciseTime& pt) const noexcept {
-    return !(*this > pt);
+  constexpr bool operator<=(const BasicPreciseTime& pt) const noexcept {
+    return !(pt < *this);
   }
 
-  constexpr bool operator>=(const PreciseTime& pt) const noexcept {
+  constexpr bool operator>=(const BasicPreciseTime& pt) const noexcept {
     return !(*this < pt);
   }
   ///
@@ -1238,45 +1466,122 @@ class PreciseTime {
 
 
   /**
-   * @brief Prints the PreciseTime in a clean format.
+   * @brief Enough characters for toChars(), mayorTimeStringToChars() and
+   * timeStringToChars() with a precision up to 64.
+   */
+  static constexpr size_t MAX_CHARS = 224;
+
+  /**
+   * @brief Writes the PreciseTime in the clean format of operator<< into
+   * [first, last) without allocating, like std::to_chars.
    * {h: [xxxx]   m: [xx]   s: [xxx]   ms: [xxx]   us: [xxx]  ns:
-   * [xxx]}^exponent
-   * @param os The output stream.
-   * @param pt The PreciseTime object to print.
-   * @return The output stream.
+   * [xxx]}^Exponent
+   * @param first The begin of the buffer.
+   * @param last The end of the buffer.
+   * @return ptr points behind the last written character. ec is
+   * std::errc::value_too_large (and ptr == last) if the buffer is too small.
    */
-  friend std::ostream& operator<<(std::ostream& os, const PreciseTime& pt) noexcept {
+  std::to_chars_result toChars(char* first, char* last) const noexcept {
     auto blanks = [](int64_t num) {
-      const int64_t i = std::abs(num);
-      if (i < 10) {
+      if (num < 10 && num > -10) {
         return "  ";
-      } else if (i < 100) {
+      } else if (num < 100 && num > -100) {
         return " ";
       }
       return "";
     };
 
-    const int64_t hours_   = pt.get<std::chrono::hours64>().count();
-    const int64_t minutes_ = pt.get<std::chrono::minutes>().count();
-    const int64_t seconds_ = pt.get<std::chrono::seconds>().count();
-    const int64_t ms       = pt.get<std::chrono::milliseconds>().count();
-    const int64_t us       = pt.get<std::chrono::microseconds>().count();
-    const int64_t ns       = pt.get<std::chrono::nanoseconds>().count();
-    const std::string exp  = std::to_string(pt.exponent);
-
+    const auto c = getSeperatedTimeComponents();
+    CharWriter out(first, last);
     // clang-format off
-    os << "{h: ["  << hours_   << "] " << blanks(hours_)
-       << "m: ["  << minutes_ << "] " << blanks(minutes_)
-       << "s: ["  << seconds_ << "] " << blanks(seconds_)
-       << "ms: [" << ms << "] " << blanks(ms)
-       << "us: [" << us << "] " << blanks(us)
-       << "ns: [" << ns  << "]}^"<< exp;
+    out << "{h: ["  << c[5] << "] " << blanks(c[5])
+        << "m: ["  << c[4] << "] " << blanks(c[4])
+        << "s: ["  << c[3] << "] " << blanks(c[3])
+        << "ms: [" << c[2] << "] " << blanks(c[2])
+        << "us: [" << c[1] << "] " << blanks(c[1])
+        << "ns: [" << c[0] << "]}^" << int64_t{Exponent};
     // clang-format on
-    if (pt.has_rolled_over) {
-      os << "\n+-----------------------------+\n"
-            "| Over- or Underflow detected |\n"
-            "+-----------------------------+";
+    if (hasRolledOver()) {
+      out << "\n+-----------------------------+\n"
+             "| Over- or Underflow detected |\n"
+             "+-----------------------------+";
     }
+    return out.result();
+  }
+
+  /**
+   * @brief Writes the time in the given unit with a fixed number of decimal
+   * places into [first, last) without allocating. E.g. for milliseconds and
+   * precision 2: "44040.07ms".
+   * @tparam c The chrono duration type of the unit.
+   * @param first The begin of the buffer.
+   * @param last The end of the buffer.
+   * @param precision The number of decimal places.
+   * @return See toChars().
+   */
+  template <class c>
+  std::to_chars_result toChars(char* first, char* last, int precision) const noexcept {
+    CharWriter out(first, last);
+    out.fixed(toDouble<c>(), precision);
+    out << timeunit2String<c>();
+    return out.result();
+  }
+
+  /**
+   * @brief Writes the most significant time unit into [first, last) without
+   * allocating. E.g. "44s". See getMayorTimeString().
+   * @param first The begin of the buffer.
+   * @param last The end of the buffer.
+   * @return See toChars().
+   */
+  std::to_chars_result mayorTimeStringToChars(char* first, char* last) const noexcept {
+    constexpr std::array<const char*, 6> UNITS = {"ns", "us", "ms", "s", "m", "h"};
+    const auto c = getSeperatedTimeComponents();
+    size_t unit  = c.size() - 1;
+    while (unit > 0 && c[unit] <= 0) {
+      --unit;
+    }
+    CharWriter out(first, last);
+    out << c[unit] << UNITS[unit];
+    return out.result();
+  }
+
+  /**
+   * @brief Writes the time in its highest format into [first, last) without
+   * allocating. See getTimeString().
+   * @param first The begin of the buffer.
+   * @param last The end of the buffer.
+   * @param precision The number of decimal places to include.
+   * @return See toChars().
+   */
+  std::to_chars_result timeStringToChars(char* first, char* last, int precision) const noexcept {
+    constexpr std::array<const char*, 6> UNITS = {"ns", "us", "ms", "s", "m", "h"};
+    constexpr std::array<double, 6> NS_PER_UNIT = {
+      1., us2ns(1.), ms2ns(1.), s2ns(1.), s2ns(m2s(1.)), h2ns(1.)};
+    const auto c = getSeperatedTimeComponents();
+    size_t unit  = c.size() - 1;
+    while (unit > 0 && c[unit] <= 0) {
+      --unit;
+    }
+    CharWriter out(first, last);
+    const double time_d = toDouble<std::chrono::nanoseconds>();
+    out.fixed(unit == 0 ? time_d : time_d / NS_PER_UNIT[unit], precision);
+    out << UNITS[unit];
+    return out.result();
+  }
+
+  /**
+   * @brief Prints the PreciseTime in a clean format.
+   * {h: [xxxx]   m: [xx]   s: [xxx]   ms: [xxx]   us: [xxx]  ns:
+   * [xxx]}^Exponent
+   * @param os The output stream.
+   * @param pt The PreciseTime object to print.
+   * @return The output stream.
+   */
+  friend std::ostream& operator<<(std::ostream& os, const BasicPreciseTime& pt) noexcept {
+    std::array<char, MAX_CHARS> buffer{};
+    const auto result = pt.toChars(buffer.data(), buffer.data() + buffer.size());
+    os.write(buffer.data(), result.ptr - buffer.data());
     return os;
   }
 
@@ -1285,33 +1590,33 @@ class PreciseTime {
    * @return The string representation of the PreciseTime.
    */
   std::string toString() const noexcept {
-    std::stringstream ss;
-    ss << *this;
-    return ss.str();
+    std::array<char, MAX_CHARS> buffer{};
+    const auto result = toChars(buffer.data(), buffer.data() + buffer.size());
+    return std::string(buffer.data(), result.ptr);
   }
 
   /**
    * @brief Returns the most significant time unit of the PreciseTime.
    * @return A PreciseTime object representing the most significant time unit.
    */
-  constexpr PreciseTime getMayorTime() const noexcept {
+  constexpr BasicPreciseTime getMayorTime() const noexcept {
     if (get<std::chrono::hours64>().count() > 0) {
-      return PreciseTime(get<std::chrono::hours64>());
+      return BasicPreciseTime(get<std::chrono::hours64>());
     }
     if (get<std::chrono::minutes>().count() > 0) {
-      return PreciseTime(get<std::chrono::minutes>());
+      return BasicPreciseTime(get<std::chrono::minutes>());
     }
     if (get<std::chrono::seconds>().count() > 0) {
-      return PreciseTime(get<std::chrono::seconds>());
+      return BasicPreciseTime(get<std::chrono::seconds>());
     }
     if (get<std::chrono::milliseconds>().count() > 0) {
-      return PreciseTime(get<std::chrono::milliseconds>());
+      return BasicPreciseTime(get<std::chrono::milliseconds>());
     }
     if (get<std::chrono::microseconds>().count() > 0) {
-      return PreciseTime(get<std::chrono::microseconds>());
+      return BasicPreciseTime(get<std::chrono::microseconds>());
     }
     if (get<std::chrono::nanoseconds>().count() > 0) {
-      return PreciseTime(get<std::chrono::nanoseconds>());
+      return BasicPreciseTime(get<std::chrono::nanoseconds>());
     }
     return zero();
   }
@@ -1321,25 +1626,9 @@ class PreciseTime {
    * @return A string representing the most significant time unit.
    */
   std::string getMayorTimeString() const noexcept {
-    if (get<std::chrono::hours64>().count() > 0) {
-      return std::to_string(get<std::chrono::hours64>().count()) + "h";
-    }
-    if (get<std::chrono::minutes>().count() > 0) {
-      return std::to_string(get<std::chrono::minutes>().count()) + "m";
-    }
-    if (get<std::chrono::seconds>().count() > 0) {
-      return std::to_string(get<std::chrono::seconds>().count()) + "s";
-    }
-    if (get<std::chrono::milliseconds>().count() > 0) {
-      return std::to_string(get<std::chrono::milliseconds>().count()) + "ms";
-    }
-    if (get<std::chrono::microseconds>().count() > 0) {
-      return std::to_string(get<std::chrono::microseconds>().count()) + "us";
-    }
-    if (get<std::chrono::nanoseconds>().count() > 0) {
-      return std::to_string(get<std::chrono::nanoseconds>().count()) + "ns";
-    }
-    return std::to_string(sub_nano_seconds) + "ns";
+    std::array<char, MAX_CHARS> buffer{};
+    const auto result = mayorTimeStringToChars(buffer.data(), buffer.data() + buffer.size());
+    return std::string(buffer.data(), result.ptr);
   }
 
 
@@ -1351,56 +1640,293 @@ class PreciseTime {
    * @return A string representing the time in its highest format.
    */
   std::string getTimeString(int precision) const noexcept {
-    double time_d = toDouble<std::chrono::nanoseconds>();
-    std::stringstream stream;
-
-    std::string unit = "ns";
-
-    if (get<std::chrono::hours64>().count() > 0) {
-      time_d = ns2h(time_d);
-      unit   = "h";
-    } else if (get<std::chrono::minutes>().count() > 0) {
-      time_d = ns2m(time_d);
-      unit   = "m";
-    } else if (get<std::chrono::seconds>().count() > 0) {
-      time_d = ns2s(time_d);
-      unit   = "s";
-    } else if (get<std::chrono::milliseconds>().count() > 0) {
-      time_d = ns2ms(time_d);
-      unit   = "ms";
-    } else if (get<std::chrono::microseconds>().count() > 0) {
-      time_d = ns2us(time_d);
-      unit   = "us";
+    std::array<char, MAX_CHARS> buffer{};
+    const auto result = timeStringToChars(buffer.data(), buffer.data() + buffer.size(), precision);
+    if (result.ec == std::errc()) {
+      return std::string(buffer.data(), result.ptr);
+    }
+    // only very high precisions do not fit into the buffer
+    std::string str(MAX_CHARS + static_cast<size_t>(precision), '\0');
+    str.resize(static_cast<size_t>(
+      timeStringToChars(&str[0], &str[0] + str.size(), precision).ptr - str.data()));
+    return str;
+  }
+
+  /**
+   * @brief Parses a PreciseTime from [first, last) without allocating, like
+   * std::from_chars. Accepted are the outputs of getTimeString(),
+   * getMayorTimeString() and toString()/operator<<, e.g. "44.04s", "66.02us",
+   * "-3h", "1.5e3ms" or
+   * "{h: [0]   m: [0]   s: [44]  ms: [40]  us: [66]  ns: [12]}^1".
+   * The units are ns, us, ms, s, m and h. The decimal number is read exactly,
+   * rounded to nanoseconds and truncated to the resolution. Leading
+   * whitespace is not skipped.
+   * @param first The begin of the input.
+   * @param last The end of the input.
+   * @param value Receives the parsed time, unchanged on error.
+   * @return ptr points behind the parsed characters. ec is
+   * std::errc::invalid_argument (and ptr == first) if the input does not
+   * start with a time and std::errc::result_out_of_range if the time does not
+   * fit into the range of this type.
+   */
+  static std::from_chars_result fromChars(const char* first,
+                                          const char* last,
+                                          BasicPreciseTime& value) noexcept {
+    CharReader in(first, last);
+    wide_int::int128 nanos(0);
+    if (in.consume("{")) {
+      if (!readLongForm(in, nanos)) {
+        return {first, std::errc::invalid_argument};
+      }
+    } else {
+      int64_t digits = 0;
+      int exponent   = 0;
+      if (!in.readDecimal(digits, exponent)) {
+        return {first, std::errc::invalid_argument};
+      }
+      // "ms" has to be checked before "m"
+      constexpr std::array<const char*, 6> UNITS = {"ns", "us", "ms", "s", "m", "h"};
+      const std::array<wide_int::int128, 6> NS_PER_UNIT = {wide_int::int128(1),
+                                                           wide_int::int128(NS_PER_US),
+                                                           wide_int::int128(NS_PER_MS),
+                                                           wide_int::int128(NS_PER_S),
+                                                           wide_int::int128(NS_PER_M),
+                                                           wide_int::int128(NS_PER_H)};
+      size_t unit = 0;
+      while (unit < UNITS.size() && !in.consume(UNITS[unit])) {
+        ++unit;
+      }
+      if (unit == UNITS.size()) {
+        return {first, std::errc::invalid_argument};
+      }
+      if (!nanosFromDecimal(digits, exponent, NS_PER_UNIT[unit], nanos)) {
+        return {in.position(), std::errc::result_out_of_range};
+      }
     }
+    return assignFromNanos(nanos, value, in.position());
+  }
 
-    stream << std::fixed << std::setprecision(precision) << time_d << unit;
+  /**
+   * @brief Parses a plain decimal number given in the unit c, e.g. "44.04"
+   * for seconds, without allocating. This reads the values written by
+   * CollectingTimer::measurementsToFile<c>().
+   * @tparam c The chrono duration type of the unit.
+   * @param first The begin of the input.
+   * @param last The end of the input.
+   * @param value Receives the parsed time, unchanged on error.
+   * @return See fromChars().
+   */
+  template <class c>
+  static std::from_chars_result fromChars(const char* first,
+                                          const char* last,
+                                          BasicPreciseTime& value) noexcept {
+    using ns_per_unit = std::ratio_divide<typename c::period, std::nano>;
+    static_assert(ns_per_unit::den == 1, "the unit must be a multiple of a nanosecond");
+
+    CharReader in(first, last);
+    int64_t digits = 0;
+    int exponent   = 0;
+    if (!in.readDecimal(digits, exponent)) {
+      return {first, std::errc::invalid_argument};
+    }
+    wide_int::int128 nanos(0);
+    if (!nanosFromDecimal(digits, exponent, wide_int::int128(ns_per_unit::num), nanos)) {
+      return {in.position(), std::errc::result_out_of_range};
+    }
+    return assignFromNanos(nanos, value, in.position());
+  }
 
-    return stream.str();
+ private:
+  /**
+   * @brief Reads the rest of the operator<< format after the "{". A trailing
+   * over- or underflow box is consumed as well.
+   */
+  static bool readLongForm(CharReader& in, wide_int::int128& nanos) noexcept {
+    constexpr std::array<const char*, 6> LABELS = {"h:", "m:", "s:", "ms:", "us:", "ns:"};
+    const std::array<wide_int::int128, 6> NS_PER_UNIT = {wide_int::int128(NS_PER_H),
+                                                         wide_int::int128(NS_PER_M),
+                                                         wide_int::int128(NS_PER_S),
+                                                         wide_int::int128(NS_PER_MS),
+                                                         wide_int::int128(NS_PER_US),
+                                                         wide_int::int128(1)};
+    wide_int::int128 sum(0);
+    for (size_t i = 0; i < LABELS.size(); ++i) {
+      int64_t component = 0;
+      if (!in.skipBlanks().consume(LABELS[i]) || !in.skipBlanks().consume("[") ||
+          !in.readInteger(component) || !in.consume("]")) {
+        return false;
+      }
+      // |h| < 2^63 and 3.6 * 10^12 ns per hour: the sum fits into 128 bit
+      sum += wide_int::int128(component) * NS_PER_UNIT[i];
+    }
+    int64_t exponent = 0;
+    if (!in.skipBlanks().consume("}^") || !in.readInteger(exponent) || exponent != Exponent) {
+      return false;
+    }
+    in.consume("\n+-----------------------------+\n"
+               "| Over- or Underflow detected |\n"
+               "+-----------------------------+");
+    nanos = sum;
+    return true;
+  }
+
+  /**
+   * @brief Computes digits * 10^exponent * nanos_per_unit rounded to the
+   * nearest integer (ties away from zero).
+   * @return false if the result does not fit into 128 bit.
+   */
+  static bool nanosFromDecimal(int64_t digits,
+                               int exponent,
+                               const wide_int::int128& nanos_per_unit,
+                               wide_int::int128& nanos) noexcept {
+    using wide_int::int128;
+    // |digits| < 10^18 and at most 3.6 * 10^12 ns per unit: fits into 128 bit
+    int128 result = int128(digits) * nanos_per_unit;
+    for (; exponent > 0 && result != int128(0); --exponent) {
+      if (!wide_int::checkedMul(result, int128(10), result)) {
+        return false;
+      }
+    }
+    // the product is below 10^31, larger divisors round it to 0
+    constexpr int MAX_DIVISOR_POWER = 32;
+    if (exponent < -MAX_DIVISOR_POWER) {
+      result = int128(0);
+    } else if (exponent < 0) {
+      int128 divisor(1);
+      for (; exponent < 0; ++exponent) {
+        divisor *= int128(10);
+      }
+      const int128 twice_rest  = (result % divisor) * int128(2);
+      result                  /= divisor;
+      if (twice_rest >= divisor) {
+        result += int128(1);
+      } else if (twice_rest <= -divisor) {
+        result -= int128(1);
+      }
+    }
+    nanos = result;
+    return true;
   }
 
-  static constexpr std::chrono::seconds MAX_VALIDE_S = std::chrono::seconds(3599);
-  static constexpr std::chrono::seconds MIN_VALIDE_S = std::chrono::seconds(-3599);
-  static constexpr std::chrono::nanoseconds MAX_VALIDE_NS =
-    std::chrono::nanoseconds(999999999);
-  static constexpr std::chrono::nanoseconds MIN_VALIDE_NS =
-    std::chrono::nanoseconds(-999999999);
+  /**
+   * @brief Converts nano units (see nanoUnits()) into the count, truncating
+   * to the resolution, and assigns it if it is in range.
+   */
+  static std::from_chars_result assignFromNanos(const wide_int::int128& nanos,
+                                                BasicPreciseTime& value,
+                                                const char* ptr) noexcept {
+    using wide_int::int128;
+    int128 ticks = nanos;
+    for (int i = 1; i < Exponent; ++i) {
+      if (!wide_int::checkedMul(ticks, int128(TICKS_PER_S), ticks)) {
+        return {ptr, std::errc::result_out_of_range};
+      }
+    }
+    ticks /= int128(NS_PER_TICK);
+    if (ticks > int128(MAX_COUNT) || ticks < int128(MIN_COUNT)) {
+      return {ptr, std::errc::result_out_of_range};
+    }
+    value.count = Rep(ticks);
+    return {ptr, std::errc()};
+  }
 
-  double sub_nano_seconds = 0.;
+  // internal value: the time in ticks of Resolution^Exponent
+  Rep count = Rep(0);
+};
 
-  // internal value to save the nano seconds
-  std::chrono::nanoseconds nano_seconds = std::chrono::nanoseconds::zero();
+/**
+ * @brief The default PreciseTime with a given unit exponent, e.g.
+ * PreciseTimePow<2> for a variance in s^2.
+ */
+template <int Exponent>
+using PreciseTimePow =
+  BasicPreciseTime<std::chrono::nanoseconds,
+                   TimeSpan<std::numeric_limits<int64_t>::max(), std::chrono::hours64>,
+                   Exponent>;
 
-  // internal value to save the seconds
-  std::chrono::seconds seconds = std::chrono::seconds::zero();
+/**
+ * @brief The default PreciseTime: nanosecond resolution covering the full
+ * range of std::chrono::hours64, stored in 128 bit.
+ */
+using PreciseTime = PreciseTimePow<1>;
 
-  // internal value to save the hours
-  std::chrono::hours64 hours = std::chrono::hours64::zero();
+/**
+ * @brief A PreciseTime packed into a single int64_t: nanosecond resolution
+ * for +-292 years. Its square is stored in 128 bit.
+ */
+using PreciseTime64 =
+  BasicPreciseTime<std::chrono::nanoseconds,
+                   TimeSpan<std::numeric_limits<int64_t>::max(), std::chrono::nanoseconds>>;
 
-  // internal value to save the unit: s, s^2, s^3...
-  int exponent = 1;
+#if defined(__cpp_lib_format)
+/**
+ * @brief std::format support for PreciseTime. Format specification:
+ * [.precision][unit] with unit one of ns, us, ms, s, m, h.
+ * "{}"      -> the clean format of operator<<
+ * "{:.2}"   -> the time in its highest unit, see getTimeString(): "44.04s"
+ * "{:.3ms}" -> the time in the given unit: "44040.066ms"
+ * A unit without precision prints 3 decimal places.
+ */
+template <class Resolution, class MaxSpan, int Exponent>
+struct std::formatter<BasicPreciseTime<Resolution, MaxSpan, Exponent>, char> {
+  constexpr auto parse(std::format_parse_context& ctx) {
+    auto it = ctx.begin();
+    if (it != ctx.end() && *it == '.') {
+      ++it;
+      precision = 0;
+      constexpr int MAX_PRECISION = 64;
+      for (; it != ctx.end() && *it >= '0' && *it <= '9'; ++it) {
+        precision = precision * 10 + (*it - '0');
+        if (precision > MAX_PRECISION) {
+          throw std::format_error("PreciseTime: precision too high");
+        }
+      }
+    }
+    const auto unit_begin = it;
+    while (it != ctx.end() && *it != '}') {
+      ++it;
+    }
+    const std::string_view unit_str(unit_begin, it);
+    constexpr std::array<std::string_view, 7> UNITS = {"", "ns", "us", "ms", "s", "m", "h"};
+    unit = UNITS.size();
+    for (size_t i = 0; i < UNITS.size(); ++i) {
+      if (unit_str == UNITS[i]) {
+        unit = i;
+      }
+    }
+    if (unit == UNITS.size()) {
+      throw std::format_error("PreciseTime: unknown unit, expected ns, us, ms, s, m or h");
+    }
+    return it;
+  }
+
+  template <class FormatContext>
+  auto format(const BasicPreciseTime<Resolution, MaxSpan, Exponent>& pt, FormatContext& ctx) const {
+    using PT = BasicPreciseTime<Resolution, MaxSpan, Exponent>;
+    constexpr int DEFAULT_PRECISION = 3;
+    const int p = precision < 0 ? DEFAULT_PRECISION : precision;
+    std::array<char, PT::MAX_CHARS> buffer{};
+    char* const first = buffer.data();
+    char* const last  = buffer.data() + buffer.size();
+    std::to_chars_result result{first, std::errc()};
+    switch (unit) {
+      case 1: result = pt.template toChars<std::chrono::nanoseconds>(first, last, p); break;
+      case 2: result = pt.template toChars<std::chrono::microseconds>(first, last, p); break;
+      case 3: result = pt.template toChars<std::chrono::milliseconds>(first, last, p); break;
+      case 4: result = pt.template toChars<std::chrono::seconds>(first, last, p); break;
+      case 5: result = pt.template toChars<std::chrono::minutes>(first, last, p); break;
+      case 6: result = pt.template toChars<std::chrono::hours64>(first, last, p); break;
+      default:
+        result = precision < 0 ? pt.toChars(first, last) : pt.timeStringToChars(first, last, p);
+        break;
+    }
+    return std::copy(first, result.ptr, ctx.out());
+  }
 
-  // keep track if we have an overor underflow.
-  bool has_rolled_over = false;
+ private:
+  int precision = -1;
+  size_t unit   = 0;
 };
+#endif
 
 #endif
@@ -0,0 +1,266 @@
+/**
+ * @file precise_time_accumulator.hpp
+ * @brief Implements PreciseTimeAccumulator: exact, mergeable count, sum and
+ * sum of squared deviations of PreciseTime samples for the mean and the
+ * variance.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef PRECISE_TIME_ACCUMULATOR_H
+#define PRECISE_TIME_ACCUMULATOR_H
+
+#include "precise_time.hpp"
+#include "precise_time_column.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Accumulates nanosecond samples exactly in wide integers: the count,
+ * the sum and the sum of squares of the distances to a shift (the first
+ * sample, or the mean for the column kernels). The parts below a nanosecond
+ * (the mean is sum / n, the squared deviations are taken from that mean) are
+ * kept as exact integer remainders instead of a rounded floating point
+ * compensation, so mean() and variance() do not depend on the order of the
+ * samples nor on how partial accumulators were merged, e.g. across threads.
+ * Only if a sum of squares exceeds 128 bit (distances of ~10^19 ns) it
+ * saturates.
+ */
+class PreciseTimeAccumulator {
+ public:
+  using int128 = wide_int::int128;
+
+  PreciseTimeAccumulator() = default;
+
+  /**
+   * @brief Accumulates all values of [data, data + n) in [lo, hi] with the
+   * SIMD kernels of PreciseTimeColumn.
+   * @param data The nanoseconds.
+   * @param n The number of values.
+   * @param lo The smallest value to include.
+   * @param hi The largest value to include.
+   * @return The accumulator.
+   */
+  static PreciseTimeAccumulator fromNanoseconds(const int64_t* data,
+                                                size_t n,
+                                                int64_t lo,
+                                                int64_t hi) noexcept {
+    PreciseTimeAccumulator acc;
+    size_t count     = 0;
+    const int128 sum = column_kernels::sum(data, n, lo, hi, count);
+    if (count == 0) {
+      return acc;
+    }
+    // the mean as shift keeps the distances small for the SIMD kernels
+    acc.count           = static_cast<uint64_t>(count);
+    acc.shift           = static_cast<int64_t>(sum / int128(acc.count));
+    acc.shifted_sum     = sum - int128(acc.count) * int128(acc.shift);
+    acc.shifted_squares = column_kernels::sumOfSquares(data, n, acc.shift, lo, hi);
+    acc.saturated       = acc.shifted_squares == wide_int::limits<int128>::max();
+    return acc;
+  }
+
+  /**
+   * @brief Takes over the count, sum and squares of column_kernels::moments().
+   * @param moments The moments.
+   * @param offset The offset the squares were taken with.
+   * @return The accumulator.
+   */
+  static PreciseTimeAccumulator fromMoments(const column_kernels::Moments& moments,
+                                            int64_t offset) noexcept {
+    PreciseTimeAccumulator acc;
+    if (moments.count == 0) {
+      return acc;
+    }
+    acc.count           = static_cast<uint64_t>(moments.count);
+    acc.shift           = offset;
+    acc.shifted_sum     = moments.sum - int128(acc.count) * int128(offset);
+    acc.shifted_squares = moments.squares.value;
+    acc.saturated       = moments.squares.saturated;
+    return acc;
+  }
+
+  /**
+   * @brief Accumulates all samples of the column in [lo, hi].
+   */
+  static PreciseTimeAccumulator fromColumn(const PreciseTimeColumn& column,
+                                           const PreciseTime& lo = PreciseTime::min(),
+                                           const PreciseTime& hi = PreciseTime::max()) noexcept {
+    return fromNanoseconds(column.data(),
+                           column.size(),
+                           PreciseTimeColumn::toNanoseconds(lo),
+                           PreciseTimeColumn::toNanoseconds(hi));
+  }
+
+  void add(const PreciseTime& value) noexcept { add(PreciseTimeColumn::toNanoseconds(value)); }
+
+  /**
+   * @brief Adds one sample: integer operations only.
+   * @param nanos The sample in nanoseconds.
+   */
+  void add(int64_t nanos) noexcept {
+    if (count == 0) {
+      shift = nanos;
+    }
+    const int128 d = int128(nanos) - int128(shift);
+    ++count;
+    shifted_sum   += d;
+    int128 square  = 0;
+    if (!wide_int::checkedMul(d, d, square)) {
+      saturated = true;
+    }
+    addSquares(square);
+  }
+
+  /**
+   * @brief Removes one sample which was added before, e.g. the oldest one of
+   * a sliding window. Exact, the result is the same as if the sample had
+   * never been added, unless the squares saturated.
+   * @param nanos The sample in nanoseconds.
+   */
+  void remove(int64_t nanos) noexcept {
+    if (count <= 1) {
+      *this = PreciseTimeAccumulator{};
+      return;
+    }
+    const int128 d = int128(nanos) - int128(shift);
+    --count;
+    shifted_sum -= d;
+    int128 square = 0;
+    if (!saturated && wide_int::checkedMul(d, d, square)) {
+      shifted_squares -= square;
+    }
+  }
+
+  /**
+   * @brief Adds the samples of another accumulator, e.g. the partial result
+   * of another thread. The result is exactly the same as if all samples had
+   * been added to one accumulator.
+   * @param other The other accumulator.
+   */
+  void merge(const PreciseTimeAccumulator& other) noexcept {
+    if (other.count == 0) {
+      return;
+    }
+    if (count == 0) {
+      *this = other;
+      return;
+    }
+    // move the moments of other to this shift:
+    // sum (x-a)^2 = sum (x-b)^2 + 2(b-a) sum (x-b) + n_b (b-a)^2
+    const int128 delta   = int128(other.shift) - int128(shift);
+    const int128 n_other = int128(other.count);
+    int128 cross         = 0;
+    int128 offset        = 0;
+    saturated            = saturated || other.saturated;
+    if (!wide_int::checkedMul(int128(2) * delta, other.shifted_sum, cross) ||
+        !wide_int::checkedMul(n_other * delta, delta, offset)) {
+      saturated = true;
+    }
+    addSquares(other.shifted_squares);
+    addSquares(cross);
+    addSquares(offset);
+    shifted_sum += other.shifted_sum + n_other * delta;
+    count       += other.count;
+  }
+
+  uint64_t getCount() const noexcept { return count; }
+
+  /**
+   * @brief Returns the exact sum of all samples.
+   */
+  PreciseTime sum() const noexcept {
+    return PreciseTime::fromCount(totalSum());
+  }
+
+  /**
+   * @brief Returns the mean truncated to nanoseconds, like
+   * PreciseTime::operator/ does. Zero if there are no samples.
+   */
+  PreciseTime mean() const noexcept {
+    if (count == 0) {
+      return PreciseTime::zero();
+    }
+    return PreciseTime::fromCount(totalSum() / int128(count));
+  }
+
+  /**
+   * @brief Returns the mean in nanoseconds including the part below a
+   * nanosecond.
+   */
+  double meanNanoseconds() const noexcept {
+    if (count == 0) {
+      return 0.;
+    }
+    int128 quotient  = 0;
+    int128 remainder = 0;
+    floorDivide(totalSum(), int128(count), quotient, remainder);
+    return wide_int::toDouble(quotient) +
+           wide_int::toDouble(remainder) / static_cast<double>(count);
+  }
+
+  /**
+   * @brief Returns the sample variance sum((x - mean)^2) / (n - 1), with the
+   * exact mean, truncated to ns^2. Zero for less than two samples, max() if
+   * the sum of squares saturated.
+   */
+  PreciseTimePow<2> variance() const noexcept {
+    if (saturated) {
+      return PreciseTimePow<2>::max();
+    }
+    if (count < 2) {
+      return PreciseTimePow<2>::zero();
+    }
+    // sum (x-mean)^2 = squares - D^2 / n with D = q n + r, 0 <= r < n:
+    // = squares - q^2 n - 2 q r - floor(r^2 / n) - (r^2 mod n) / n
+    const int128 n = int128(count);
+    int128 q       = 0;
+    int128 r       = 0;
+    floorDivide(shifted_sum, n, q, r);
+    const int128 r_squared = r * r;
+    const int128 whole =
+      shifted_squares - q * q * n - int128(2) * q * r - r_squared / n;
+    const int128 fraction = r_squared % n;  // in 1/n
+
+    // (whole - fraction / n) / (n - 1), truncated
+    int128 variance   = whole / (n - int128(1));
+    const int128 rest = whole % (n - int128(1));
+    if (rest * n < fraction) {
+      variance -= int128(1);
+    }
+    return PreciseTimePow<2>::fromCount(variance);
+  }
+
+  /**
+   * @brief Returns the sample standard deviation, the square root of
+   * variance().
+   */
+  PreciseTime standardDeviation() const noexcept { return variance().getSqrt(); }
+
+ private:
+  int128 totalSum() const noexcept { return shifted_sum + int128(count) * int128(shift); }
+
+  void addSquares(const int128& value) noexcept {
+    if (!saturated && !wide_int::checkedAdd(shifted_squares, value, shifted_squares)) {
+      saturated = true;
+    }
+  }
+
+  static void floorDivide(const int128& a, const int128& b, int128& quotient, int128& remainder) noexcept {
+    quotient  = a / b;
+    remainder = a % b;
+    if (remainder < int128(0)) {
+      quotient  -= int128(1);
+      remainder += b;
+    }
+  }
+
+  uint64_t count         = 0;
+  int64_t shift          = 0;
+  int128 shifted_sum     = 0;  // sum (x - shift)
+  int128 shifted_squares = 0;  // sum (x - shift)^2
+  bool saturated         = false;
+};
+
+#endif
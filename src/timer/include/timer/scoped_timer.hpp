@@ -10,18 +10,24 @@
 #ifndef SCOPED_TIMER_H
 #define SCOPED_TIMER_H
 
+#include "clock.hpp"
 #include "precise_time.hpp"
+#include <array>
+#include <cstdio>
 #include <functional>
 
 /*!
  * @brief A Scoped timer. It will start recording on creation and stop recording
  * on destruction. The recorded time will be reported via a given callback
  * function.
+ * @tparam Clock The clock policy, see clock.hpp.
  */
-class ScopedTimer {
+template <class Clock = DefaultClock>
+class BasicScopedTimer {
  public:
+  using time_point = typename Clock::time_point;
   using reportBack =
-    std::function<void(const std::string&, const PreciseTime::PrecisionClock::time_point&, const PreciseTime& time)>;
+    std::function<void(const std::string&, const time_point&, const PreciseTime& time)>;
 
   /*!
    * @brief Constructor, Starts timer.
@@ -30,22 +36,25 @@ class ScopedTimer {
    * ScopedTimer::reportBack which will be called on destruction reporting the
    * time and the name.
    */
-  ScopedTimer(const std::string& timer_name, const reportBack& report_back_callback)
+  BasicScopedTimer(const std::string& timer_name, const reportBack& report_back_callback)
       : name(timer_name),
-        start(PreciseTime::PrecisionClock::now()),
+        start(Clock::start()),
         report_back(report_back_callback) {}
 
   /*!
    * @brief Constructor, Starts timer. WHen the timer ends it will automatically print the timeing via cout.
    * @param name The name of the timer.
    */
-  ScopedTimer(const std::string& timer_name)
+  BasicScopedTimer(const std::string& timer_name)
       : name(timer_name),
-        start(PreciseTime::PrecisionClock::now()),
+        start(Clock::start()),
         report_back([](const std::string& name_,
-                       const PreciseTime::PrecisionClock::time_point&,
+                       const time_point&,
                        const PreciseTime& time) {
-          printf("Timer %s stopped after %s\n", name_.c_str(), time.toString().c_str());
+          // formatted on the stack, reporting does not allocate
+          std::array<char, PreciseTime::MAX_CHARS + 1> buffer{};
+          *time.toChars(buffer.data(), buffer.data() + PreciseTime::MAX_CHARS).ptr = '\0';
+          printf("Timer %s stopped after %s\n", name_.c_str(), buffer.data());
         }) {}
 
   void stop() {
@@ -53,19 +62,19 @@ class ScopedTimer {
       return;
     }
     stopped         = true;
-    const auto stop = PreciseTime::PrecisionClock::now();
-    const auto duration =
-      std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
-    report_back(name, start, duration);
+    const time_point stop = Clock::stop();
+    report_back(name, start, Clock::elapsed(start, stop));
   }
 
-  ~ScopedTimer() { stop(); }
+  ~BasicScopedTimer() { stop(); }
 
  private:
   const std::string name;
-  const PreciseTime::PrecisionClock::time_point start;
+  const time_point start;
   const reportBack report_back;
   bool stopped = false;
 };
 
+using ScopedTimer = BasicScopedTimer<>;
+
 #endif
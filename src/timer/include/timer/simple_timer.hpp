@@ -8,22 +8,22 @@
 
 #ifndef SIMPLE_TIMER_H
 #define SIMPLE_TIMER_H
+#include "clock.hpp"
 #include <chrono>
 
 /*!
  * @brief A Single timer without statistic support.
+ * @tparam Clock The clock policy, see clock.hpp.
  */
-class SingleTimer {
+template <class Clock = DefaultClock>
+class BasicSingleTimer {
  public:
-  typedef std::conditional<std::chrono::high_resolution_clock::is_steady,
-                           std::chrono::high_resolution_clock,
-                           std::chrono::steady_clock>::type PrecisionClock;
   /*!
    * @brief Start one Simple Timer. No Statistics will be generated.
    */
   void start() {
     started    = true;
-    start_time = PrecisionClock::now();
+    start_time = Clock::start();
   }
 
   /*!
@@ -43,16 +43,19 @@ class SingleTimer {
    */
   template <class T>
   T getPassedTime() const {
-    const auto stop_time = PrecisionClock::now();
+    const auto stop_time = Clock::stop();
     if (!started) {
-      return std::chrono::duration_cast<T>(stop_time - stop_time);
+      return T::zero();
     }
-    return std::chrono::duration_cast<T>(stop_time - start_time);
+    const int64_t ticks = Clock::elapsedTicks(start_time, stop_time);
+    return std::chrono::duration_cast<T>(std::chrono::nanoseconds(Clock::toNanoseconds(ticks)));
   }
 
  private:
-  PrecisionClock::time_point start_time;
+  typename Clock::time_point start_time;
   bool started = false;
 };
 
+using SingleTimer = BasicSingleTimer<>;
+
 #endif
@@ -0,0 +1,537 @@
+/**
+ * @file wide_int.hpp
+ * @brief Implements a portable signed 128 bit integer and helpers to treat
+ * builtin and emulated integers alike. Used as storage for PreciseTime.
+ * @date 16.10.2026
+ * @author Jakob Wandel
+ * @version 1.0
+ **/
+
+#ifndef WIDE_INT_H
+#define WIDE_INT_H
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace wide_int {
+
+/**
+ * @brief A constexpr signed 128 bit integer (two's complement) for platforms
+ * without __int128 (MSVC, 32 bit). Only implements what PreciseTime needs.
+ */
+class Int128 {
+ public:
+  constexpr Int128() = default;
+
+  /**
+   * @brief Constructs from any builtin integer (sign extended).
+   * @param v The value.
+   */
+  template <class I, typename std::enable_if<std::is_integral<I>::value, int>::type = 0>
+  constexpr Int128(I v) noexcept  // NOLINT implicit like a builtin integer
+      : lo(static_cast<uint64_t>(v)),
+        hi(isNegative(v) ? -1 : 0) {}
+
+  /**
+   * @brief Constructs from the two halves.
+   * @param high The upper 64 bit.
+   * @param low The lower 64 bit.
+   */
+  static constexpr Int128 fromParts(int64_t high, uint64_t low) noexcept {
+    Int128 r;
+    r.hi = high;
+    r.lo = low;
+    return r;
+  }
+
+  /**
+   * @brief Converts a double (truncating towards zero). The caller must make
+   * sure the value fits.
+   * @param d The value.
+   * @return The converted value.
+   */
+  static constexpr Int128 fromDouble(double d) noexcept {
+    const bool negative = d < 0.;
+    const double mag    = negative ? -d : d;
+    const double high_d = mag / TWO_POW_64;
+    const auto high     = static_cast<uint64_t>(high_d);
+    const double low_d  = mag - static_cast<double>(high) * TWO_POW_64;
+    const Int128 r = fromParts(static_cast<int64_t>(high), static_cast<uint64_t>(low_d));
+    return negative ? -r : r;
+  }
+
+  template <class I, typename std::enable_if<std::is_integral<I>::value, int>::type = 0>
+  explicit constexpr operator I() const noexcept {
+    return static_cast<I>(lo);
+  }
+
+  explicit constexpr operator double() const noexcept {
+    // the magnitude read as unsigned, so min() works as well
+    const Int128 mag = hi < 0 ? -*this : *this;
+    const double value =
+      static_cast<double>(static_cast<uint64_t>(mag.hi)) * TWO_POW_64 + static_cast<double>(mag.lo);
+    return hi < 0 ? -value : value;
+  }
+
+  explicit constexpr operator bool() const noexcept { return hi != 0 || lo != 0; }
+
+  constexpr int64_t high() const noexcept { return hi; }
+  constexpr uint64_t low() const noexcept { return lo; }
+
+  friend constexpr Int128 operator+(const Int128& a, const Int128& b) noexcept {
+    const uint64_t low = a.lo + b.lo;
+    const uint64_t carry = low < a.lo ? 1U : 0U;
+    return fromParts(static_cast<int64_t>(static_cast<uint64_t>(a.hi) +
+                                          static_cast<uint64_t>(b.hi) + carry),
+                     low);
+  }
+
+  friend constexpr Int128 operator-(const Int128& a) noexcept {
+    return fromParts(static_cast<int64_t>(~static_cast<uint64_t>(a.hi)), ~a.lo) + Int128(1);
+  }
+
+  friend constexpr Int128 operator-(const Int128& a, const Int128& b) noexcept {
+    return a + (-b);
+  }
+
+  friend constexpr Int128 operator*(const Int128& a, const Int128& b) noexcept {
+    // (a.hi * 2^64 + a.lo) * (b.hi * 2^64 + b.lo) mod 2^128
+    const Int128 low_product = mulU64(a.lo, b.lo);
+    const uint64_t cross =
+      static_cast<uint64_t>(a.hi) * b.lo + a.lo * static_cast<uint64_t>(b.hi);
+    return fromParts(static_cast<int64_t>(static_cast<uint64_t>(low_product.hi) + cross),
+                     low_product.lo);
+  }
+
+  friend constexpr Int128 operator/(const Int128& a, const Int128& b) noexcept {
+    Int128 remainder;
+    return divMod(a, b, remainder);
+  }
+
+  friend constexpr Int128 operator%(const Int128& a, const Int128& b) noexcept {
+    Int128 remainder;
+    divMod(a, b, remainder);
+    return remainder;
+  }
+
+  constexpr Int128& operator+=(const Int128& b) noexcept { return *this = *this + b; }
+  constexpr Int128& operator-=(const Int128& b) noexcept { return *this = *this - b; }
+  constexpr Int128& operator*=(const Int128& b) noexcept { return *this = *this * b; }
+  constexpr Int128& operator/=(const Int128& b) noexcept { return *this = *this / b; }
+  constexpr Int128& operator%=(const Int128& b) noexcept { return *this = *this % b; }
+
+  friend constexpr bool operator==(const Int128& a, const Int128& b) noexcept {
+    return a.hi == b.hi && a.lo == b.lo;
+  }
+  friend constexpr bool operator!=(const Int128& a, const Int128& b) noexcept {
+    return !(a == b);
+  }
+  friend constexpr bool operator<(const Int128& a, const Int128& b) noexcept {
+    return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+  }
+  friend constexpr bool operator>(const Int128& a, const Int128& b) noexcept {
+    return b < a;
+  }
+  friend constexpr bool operator<=(const Int128& a, const Int128& b) noexcept {
+    return !(b < a);
+  }
+  friend constexpr bool operator>=(const Int128& a, const Int128& b) noexcept {
+    return !(a < b);
+  }
+
+  /**
+   * @brief Full 64x64 -> 128 bit unsigned multiplication.
+   * @param a First factor.
+   * @param b Second factor.
+   * @return The product as bit pattern.
+   */
+  static constexpr Int128 mulU64(uint64_t a, uint64_t b) noexcept {
+    constexpr uint64_t MASK = 0xFFFFFFFFULL;
+    const uint64_t a_lo     = a & MASK;
+    const uint64_t a_hi     = a >> 32U;
+    const uint64_t b_lo     = b & MASK;
+    const uint64_t b_hi     = b >> 32U;
+
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t hi_hi = a_hi * b_hi;
+
+    const uint64_t middle = (lo_lo >> 32U) + (hi_lo & MASK) + lo_hi;
+    const uint64_t low    = (middle << 32U) | (lo_lo & MASK);
+    const uint64_t high   = hi_hi + (hi_lo >> 32U) + (middle >> 32U);
+    return fromParts(static_cast<int64_t>(high), low);
+  }
+
+ private:
+  template <class I>
+  static constexpr bool isNegative(I v) noexcept {
+    if constexpr (std::is_signed<I>::value) {
+      return v < 0;
+    } else {
+      return false;
+    }
+  }
+
+  static constexpr double TWO_POW_64 = 18446744073709551616.0;
+
+  /**
+   * @brief Signed division truncating towards zero, like builtin integers.
+   * @param a Dividend.
+   * @param b Divisor (must not be zero).
+   * @param remainder Set to a - quotient * b.
+   * @return The quotient.
+   */
+  static constexpr Int128 divMod(const Int128& a, const Int128& b, Int128& remainder) noexcept {
+    const bool a_negative = a.hi < 0;
+    const bool b_negative = b.hi < 0;
+    const Int128 n        = a_negative ? -a : a;
+    const Int128 d        = b_negative ? -b : b;
+
+    Int128 q;
+    Int128 r;
+    if (n.hi == 0 && d.hi == 0) {
+      q = fromParts(0, n.lo / d.lo);
+      r = fromParts(0, n.lo % d.lo);
+    } else {
+      // restoring long division on the magnitudes
+      for (int bit = 127; bit >= 0; --bit) {
+        r = shiftLeftOne(r);
+        if (n.bit(bit)) {
+          r.lo |= 1U;
+        }
+        if (!lessUnsigned(r, d)) {
+          r = r - d;
+          q.setBit(bit);
+        }
+      }
+    }
+    remainder = a_negative ? -r : r;
+    return a_negative != b_negative ? -q : q;
+  }
+
+  static constexpr Int128 shiftLeftOne(const Int128& v) noexcept {
+    return fromParts(static_cast<int64_t>((static_cast<uint64_t>(v.hi) << 1U) | (v.lo >> 63U)),
+                     v.lo << 1U);
+  }
+
+  static constexpr bool lessUnsigned(const Int128& a, const Int128& b) noexcept {
+    const auto a_hi = static_cast<uint64_t>(a.hi);
+    const auto b_hi = static_cast<uint64_t>(b.hi);
+    return a_hi < b_hi || (a_hi == b_hi && a.lo < b.lo);
+  }
+
+  constexpr bool bit(int index) const noexcept {
+    if (index >= 64) {
+      return ((static_cast<uint64_t>(hi) >> static_cast<unsigned>(index - 64)) & 1U) != 0;
+    }
+    return ((lo >> static_cast<unsigned>(index)) & 1U) != 0;
+  }
+
+  constexpr void setBit(int index) noexcept {
+    if (index >= 64) {
+      hi = static_cast<int64_t>(static_cast<uint64_t>(hi) |
+                                (uint64_t{1} << static_cast<unsigned>(index - 64)));
+    } else {
+      lo |= uint64_t{1} << static_cast<unsigned>(index);
+    }
+  }
+
+  uint64_t lo = 0;
+  int64_t hi  = 0;
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WIDE_INT_OVERFLOW_BUILTINS 1
+#else
+#define WIDE_INT_OVERFLOW_BUILTINS 0
+#endif
+
+#if defined(__SIZEOF_INT128__) && !defined(PRECISE_TIME_NO_INT128)
+__extension__ typedef __int128 int128;  // NOLINT modernize-use-using: __extension__ needs typedef
+#else
+using int128 = Int128;
+#endif
+
+/**
+ * @brief numeric_limits replacement which also works for __int128 in strict
+ * ISO mode and for the emulated Int128.
+ * @tparam T The integer type.
+ */
+template <class T>
+struct limits {
+  static constexpr T max() noexcept { return std::numeric_limits<T>::max(); }
+  static constexpr T min() noexcept { return std::numeric_limits<T>::min(); }
+  static constexpr int digits = std::numeric_limits<T>::digits;
+};
+
+template <>
+struct limits<Int128> {
+  static constexpr Int128 max() noexcept {
+    return Int128::fromParts(std::numeric_limits<int64_t>::max(),
+                             std::numeric_limits<uint64_t>::max());
+  }
+  static constexpr Int128 min() noexcept {
+    return Int128::fromParts(std::numeric_limits<int64_t>::min(), 0);
+  }
+  static constexpr int digits = 127;
+};
+
+#if defined(__SIZEOF_INT128__) && !defined(PRECISE_TIME_NO_INT128)
+template <>
+struct limits<int128> {
+  static constexpr int128 max() noexcept {
+    const int128 half = static_cast<int128>(1) << 126U;
+    return (half - 1) + half;
+  }
+  static constexpr int128 min() noexcept { return -max() - 1; }
+  static constexpr int digits = 127;
+};
+#endif
+
+/**
+ * @brief Converts a double into T, saturating at the limits of T.
+ * @tparam T The integer type.
+ * @param d The value (truncated towards zero).
+ * @return The converted value.
+ */
+template <class T>
+constexpr T fromDouble(double d) noexcept {
+  constexpr double max_d = static_cast<double>(limits<T>::max());
+  constexpr double min_d = static_cast<double>(limits<T>::min());
+  if (d >= max_d) {
+    return limits<T>::max();
+  }
+  if (d <= min_d) {
+    return limits<T>::min();
+  }
+  if constexpr (std::is_same<T, Int128>::value) {
+    return Int128::fromDouble(d);
+  } else {
+    return static_cast<T>(d);
+  }
+}
+
+/**
+ * @brief Converts T into a double.
+ * @tparam T The integer type.
+ * @param v The value.
+ * @return The converted value.
+ */
+template <class T>
+constexpr double toDouble(const T& v) noexcept {
+  return static_cast<double>(v);
+}
+
+/**
+ * @brief Adds a and b. Returns false and leaves result untouched if the result
+ * would overflow T.
+ * @tparam T The integer type.
+ * @param a First summand.
+ * @param b Second summand.
+ * @param result The sum.
+ * @return true on success.
+ */
+template <class T>
+constexpr bool checkedAdd(const T& a, const T& b, T& result) noexcept {
+#if WIDE_INT_OVERFLOW_BUILTINS
+  if constexpr (!std::is_same<T, Int128>::value) {
+    T sum{};
+    if (__builtin_add_overflow(a, b, &sum)) {
+      return false;
+    }
+    result = sum;
+    return true;
+  }
+#endif
+  if ((b > T(0) && a > limits<T>::max() - b) || (b < T(0) && a < limits<T>::min() - b)) {
+    return false;
+  }
+  result = a + b;
+  return true;
+}
+
+/**
+ * @brief Subtracts b from a. Returns false and leaves result untouched if the
+ * result would overflow T.
+ * @tparam T The integer type.
+ * @param a The minuend.
+ * @param b The subtrahend.
+ * @param result The difference.
+ * @return true on success.
+ */
+template <class T>
+constexpr bool checkedSub(const T& a, const T& b, T& result) noexcept {
+#if WIDE_INT_OVERFLOW_BUILTINS
+  if constexpr (!std::is_same<T, Int128>::value) {
+    T difference{};
+    if (__builtin_sub_overflow(a, b, &difference)) {
+      return false;
+    }
+    result = difference;
+    return true;
+  }
+#endif
+  if ((b < T(0) && a > limits<T>::max() + b) || (b > T(0) && a < limits<T>::min() + b)) {
+    return false;
+  }
+  result = a - b;
+  return true;
+}
+
+/**
+ * @brief Multiplies a and b. Returns false and leaves result untouched if the
+ * result would overflow T.
+ * @tparam T The integer type.
+ * @param a First factor.
+ * @param b Second factor.
+ * @param result The product.
+ * @return true on success.
+ */
+template <class T>
+constexpr bool checkedMul(const T& a, const T& b, T& result) noexcept {
+#if WIDE_INT_OVERFLOW_BUILTINS
+  if constexpr (!std::is_same<T, Int128>::value) {
+    T product{};
+    if (__builtin_mul_overflow(a, b, &product)) {
+      return false;
+    }
+    result = product;
+    return true;
+  }
+#endif
+  if (a == T(0) || b == T(0)) {
+    result = T(0);
+    return true;
+  }
+  if (a == limits<T>::min() || b == limits<T>::min()) {
+    if (a == T(1) || b == T(1)) {
+      result = a * b;
+      return true;
+    }
+    return false;
+  }
+  const T abs_a = a < T(0) ? -a : a;
+  const T abs_b = b < T(0) ? -b : b;
+  if (abs_a > limits<T>::max() / abs_b) {
+    return false;
+  }
+  result = a * b;
+  return true;
+}
+
+/**
+ * @brief Returns 2^shift.
+ * @tparam T The integer type.
+ * @param shift The exponent, must be smaller than the number of value bits of T.
+ * @return 2^shift.
+ */
+template <class T>
+constexpr T pow2(int shift) noexcept {
+  if constexpr (std::is_same<T, Int128>::value) {
+    constexpr int HALF = 64;
+    return shift < HALF ? Int128::fromParts(0, uint64_t{1} << static_cast<unsigned>(shift))
+                        : Int128::fromParts(int64_t{1} << static_cast<unsigned>(shift - HALF), 0);
+  } else {
+    return static_cast<T>(T(1) << static_cast<unsigned>(shift));
+  }
+}
+
+/**
+ * @brief Divides value by 2^shift, truncating towards zero like an integer
+ * division.
+ * @tparam T The integer type.
+ * @param value The dividend.
+ * @param shift The exponent, must be smaller than the number of value bits of T.
+ * @return value / 2^shift.
+ */
+template <class T>
+constexpr T divPow2(const T& value, int shift) noexcept {
+  if constexpr (std::is_same<T, Int128>::value) {
+    return value / pow2<T>(shift);
+  } else {
+    // arithmetic shift rounds down, so negative values are biased first
+    const T bias = value < T(0) ? pow2<T>(shift) - T(1) : T(0);
+    return static_cast<T>((value + bias) >> static_cast<unsigned>(shift));
+  }
+}
+
+/**
+ * @brief Splits d exactly into mantissa / 2^shift with the smallest shift.
+ * @param d The value.
+ * @param mantissa The whole number part.
+ * @param shift The power of two d was scaled with.
+ * @return false if d is not finite, too big or too small to be split into an
+ * int64_t mantissa and a shift below 128.
+ */
+constexpr bool toDyadic(double d, int64_t& mantissa, int& shift) noexcept {
+  constexpr double LIMIT = 0x1p62;
+  // values beyond 2^53 are whole numbers, so this also covers infinity
+  auto is_whole = [](double v) {
+    return !(v < LIMIT && v > -LIMIT) || static_cast<double>(static_cast<int64_t>(v)) == v;
+  };
+  auto scale = [](double v, int exponent) {
+    // 2^exponent by squaring, powers of two are exact in floating point
+    double factor = 1.;
+    double base   = 2.;
+    for (auto bits = static_cast<unsigned>(exponent); bits != 0U; bits >>= 1U, base *= base) {
+      if ((bits & 1U) != 0U) {
+        factor *= base;
+      }
+    }
+    return v * factor;
+  };
+  if (!(d < LIMIT && d > -LIMIT)) {
+    return false;
+  }
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+  if (!__builtin_is_constant_evaluated()) {
+    // read the IEEE 754 fields directly: d = fraction * 2^(biased_exponent - 1075)
+    constexpr int FRACTION_BITS   = 52;
+    constexpr int EXPONENT_OFFSET = 1075;
+    constexpr uint64_t EXPONENT_MASK = 0x7FFU;
+    constexpr uint64_t FRACTION_MASK = (uint64_t{1} << FRACTION_BITS) - 1U;
+    uint64_t bits = 0;
+    std::memcpy(&bits, &d, sizeof(bits));
+    const auto biased_exponent = static_cast<int>((bits >> FRACTION_BITS) & EXPONENT_MASK);
+    if (biased_exponent == 0 || d == 0.) {
+      return false;  // zero and subnormals
+    }
+    uint64_t fraction = (bits & FRACTION_MASK) | (uint64_t{1} << FRACTION_BITS);
+    shift             = EXPONENT_OFFSET - biased_exponent;
+    // drop trailing zero bits to get the smallest shift
+    const int zeros = __builtin_ctzll(fraction);
+    const int drop  = zeros < shift ? zeros : shift;
+    if (drop > 0) {
+      fraction >>= static_cast<unsigned>(drop);
+      shift     -= drop;
+    }
+    if (shift < 0 || shift >= 127) {
+      return false;
+    }
+    mantissa = d < 0. ? -static_cast<int64_t>(fraction) : static_cast<int64_t>(fraction);
+    return true;
+  }
+#endif
+#endif
+  // d * 2^k stays whole once it is whole: binary search the smallest k
+  shift = 0;
+  for (int step = 64; step > 0; step /= 2) {
+    if (!is_whole(scale(d, shift + step - 1))) {
+      shift += step;
+    }
+  }
+  const double scaled = scale(d, shift);
+  if (shift >= 127 || !(scaled < LIMIT && scaled > -LIMIT)) {
+    return false;
+  }
+  mantissa = static_cast<int64_t>(scaled);
+  return true;
+}
+
+}  // namespace wide_int
+
+#endif